@@ -0,0 +1,221 @@
+//! Compares two ways to run the searches of `prepare_root_distances` for a variable with `rows` embedded neighbors:
+//! one node-weighted Dijkstra search per neighbor, as in pathfinder.hpp, against a "lane" search, which runs up to
+//! eight of them together.  The lane search stores the tentative distances of every lane at a qubit side by side and,
+//! when a qubit is expanded, reads its adjacency list and the weights of its neighbors once for every lane expanded
+//! with it.  Qubits are expanded in order of their least pending distance, along with every lane whose distance lies
+//! in the same bucket of width `width`; with a width above one, the search is label-correcting.
+//!
+//! The lane search here tracks distances only.  To replace the serial searches it would also have to track the parent
+//! that the serial search picks, so its times are a lower bound.
+//!
+//! usage: lane_search [pegasus size (16)] [rows (16)] [rounds (20)] [cluster (4)]
+//!
+//! the searches start from single qubits, chosen at random ("spread") or within `cluster` hops of one qubit
+//! ("clustered"), as the chains of the neighbors of a variable tend to be.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <vector>
+#include "../include/generators.hpp"
+#include "../include/util.hpp"
+
+using namespace find_embedding;
+using std::vector;
+
+struct workload {
+    vector<vector<int>> nbrs;
+    vector<distance_t> weight;
+    vector<vector<int>> permutations;
+    vector<int> roots;
+};
+
+//! one search per row; returns the distances of every row, back to back
+vector<distance_t> serial(const workload &w) {
+    const int num_qubits = w.nbrs.size(), rows = w.roots.size();
+    vector<distance_t> dist(static_cast<size_t>(rows) * num_qubits, max_distance);
+    vector<int> visited(num_qubits);
+    distance_queue pq(num_qubits);
+    for (int v = 0; v < rows; v++) {
+        distance_t *d = dist.data() + static_cast<size_t>(v) * num_qubits;
+        std::fill(std::begin(visited), std::end(visited), 0);
+        pq.reset();
+        pq.emplace(w.roots[v], w.permutations[v][w.roots[v]], 0);
+        visited[w.roots[v]] = 1;
+        while (!pq.empty()) {
+            auto z = pq.top();
+            pq.pop();
+            d[z.node] = z.dist;
+            for (auto &p : w.nbrs[z.node]) {
+                if (visited[p]) continue;
+                visited[p] = 1;
+                pq.emplace(p, w.permutations[v][p], z.dist + w.weight[p]);
+            }
+        }
+    }
+    return dist;
+}
+
+class lanes {
+  public:
+    static constexpr int width = 8;
+    using lane_mask = uint8_t;
+    using entry = std::pair<distance_t, int>;
+
+  private:
+    vector<distance_t> label;
+    vector<lane_mask> dirty;
+    vector<entry> heap;
+
+  public:
+    //! the number of lanes expanded, and of expansions, in all calls to `run`
+    long long lanes_expanded = 0;
+    long long expansions = 0;
+
+    explicit lanes(int num_nodes) : label(static_cast<size_t>(num_nodes) * width), dirty(num_nodes), heap() {}
+
+    inline const distance_t *distances(int q) const { return label.data() + static_cast<size_t>(q) * width; }
+
+    //! search from `roots[l]` in lane `l`, for each of the `count` roots
+    void run(const workload &w, const int *roots, int count, distance_t bucket) {
+        std::fill(std::begin(label), std::end(label), max_distance);
+        heap.clear();
+        for (int l = 0; l < count; l++) {
+            label[static_cast<size_t>(roots[l]) * width + l] = 0;
+            dirty[roots[l]] |= 1 << l;
+            push(0, roots[l]);
+        }
+        while (!heap.empty()) {
+            std::pop_heap(std::begin(heap), std::end(heap), std::greater<entry>());
+            const distance_t key = heap.back().first;
+            const int q = heap.back().second;
+            heap.pop_back();
+            if (least_pending(q) != key) continue;
+
+            const distance_t limit = key - key % bucket + bucket;
+            const distance_t *dq = distances(q);
+            lane_mask expand = 0;
+            for (int l = 0; l < count; l++)
+                if ((dirty[q] >> l & 1) && dq[l] < limit) expand |= 1 << l;
+            dirty[q] &= ~expand;
+            expansions++;
+            for (lane_mask m = expand; m; m &= m - 1) lanes_expanded++;
+
+            for (auto &p : w.nbrs[q]) {
+                const distance_t wp = w.weight[p];
+                distance_t *dp = label.data() + static_cast<size_t>(p) * width;
+                lane_mask improved = 0;
+                for (int l = 0; l < count; l++) {
+                    if ((expand >> l & 1) && dq[l] + wp < dp[l]) {
+                        dp[l] = dq[l] + wp;
+                        improved |= 1 << l;
+                    }
+                }
+                if (improved) {
+                    dirty[p] |= improved;
+                    push(least_pending(p), p);
+                }
+            }
+            if (dirty[q]) push(least_pending(q), q);
+        }
+    }
+
+  private:
+    inline void push(distance_t d, int q) {
+        heap.emplace_back(d, q);
+        std::push_heap(std::begin(heap), std::end(heap), std::greater<entry>());
+    }
+
+    inline distance_t least_pending(int q) const {
+        const distance_t *dq = distances(q);
+        distance_t d = max_distance;
+        for (int l = 0; l < width; l++)
+            if (dirty[q] >> l & 1) d = std::min(d, dq[l]);
+        return d;
+    }
+};
+
+//! the rows in groups of `lanes::width`; returns the distances of every row, back to back
+vector<distance_t> grouped(const workload &w, lanes &engine, distance_t bucket) {
+    const int num_qubits = w.nbrs.size(), rows = w.roots.size();
+    vector<distance_t> dist(static_cast<size_t>(rows) * num_qubits);
+    for (int v0 = 0; v0 < rows; v0 += lanes::width) {
+        const int count = std::min(lanes::width, rows - v0);
+        engine.run(w, w.roots.data() + v0, count, bucket);
+        for (int q = 0; q < num_qubits; q++)
+            for (int l = 0; l < count; l++) dist[static_cast<size_t>(v0 + l) * num_qubits + q] = engine.distances(q)[l];
+    }
+    return dist;
+}
+
+template <typename search_t>
+double measure(search_t search, const vector<distance_t> &expected, int rounds) {
+    if (search() != expected) {
+        printf("distances differ\n");
+        exit(1);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) search();
+    return 1000 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+void report(const char *name, const workload &w, int rounds) {
+    const int num_qubits = w.nbrs.size();
+    auto expected = serial(w);
+    printf("%s roots\n", name);
+    printf("  %-12s %10.3f ms/round\n", "serial", measure([&w]() { return serial(w); }, expected, rounds));
+    for (distance_t bucket : {1, 16, 64}) {
+        lanes engine(num_qubits);
+        double ms = measure([&]() { return grouped(w, engine, bucket); }, expected, rounds);
+        printf("  lanes, %-5lld %10.3f ms/round  %.2f lanes per expansion\n", static_cast<long long>(bucket), ms,
+               static_cast<double>(engine.lanes_expanded) / engine.expansions);
+    }
+}
+
+int main(int argc, char **argv) {
+    int m = argc > 1 ? atoi(argv[1]) : 16;
+    int rows = argc > 2 ? atoi(argv[2]) : 16;
+    int rounds = argc > 3 ? atoi(argv[3]) : 20;
+    int cluster = argc > 4 ? atoi(argv[4]) : 4;
+
+    graph::input_graph target = graph::pegasus(m);
+    workload w;
+    int num_qubits = target.num_nodes();
+    w.nbrs.resize(num_qubits);
+    for (int i = 0; i < target.num_edges(); i++) {
+        w.nbrs[target.a(i)].push_back(target.b(i));
+        w.nbrs[target.b(i)].push_back(target.a(i));
+    }
+    // a quarter of the qubits are already in use, and cost as much as an unused path of 64 qubits
+    fastrng rng(UINT64_C(1));
+    w.weight.resize(num_qubits);
+    for (int q = 0; q < num_qubits; q++) w.weight[q] = (rng() & 3) == 0 ? 64 : 1;
+    vector<int> permutation(num_qubits);
+    std::iota(std::begin(permutation), std::end(permutation), 0);
+    for (int v = 0; v < rows; v++) {
+        for (int i = num_qubits; i > 1; i--) std::swap(permutation[i - 1], permutation[rng() % i]);
+        w.permutations.push_back(permutation);
+    }
+
+    printf("pegasus(%d): %d qubits, %d rows, %d rounds\n", m, num_qubits, rows, rounds);
+    int center;
+    do center = rng() % num_qubits;
+    while (w.nbrs[center].empty());
+    for (int v = 0; v < rows; v++) {
+        int root;
+        do root = rng() % num_qubits;
+        while (w.nbrs[root].empty());
+        w.roots.push_back(root);
+    }
+    report("spread", w, rounds);
+    for (int v = 0; v < rows; v++) {
+        int root = center;
+        for (int hop = 0; hop < cluster; hop++) root = w.nbrs[root][rng() % w.nbrs[root].size()];
+        w.roots[v] = root;
+    }
+    report("clustered", w, rounds);
+    return 0;
+}
@@ -0,0 +1,180 @@
+//! Compares memory layouts for the per-qubit state of the searches in pathfinder.hpp.  Each round mimics the work
+//! of `find_chain` for a variable with `rows` embedded neighbors: a node-weighted Dijkstra search from the chain of
+//! each neighbor, each followed by the accumulation of its distances into a running total.
+//!
+//! usage: search_layout [pegasus size (16)] [rows (16)] [rounds (20)]
+//!
+//! layouts:
+//!   split   -- as pathfinder_base holds them: separate rows of visited flags, parents, permutations and distances
+//!              for each variable
+//!   packed  -- one record {distance, parent, visited} per variable per qubit, permutations apart (they're swapped
+//!              between variables as whole rows)
+//!   full    -- one record {distance, parent, visited, permutation} per variable per qubit
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+#include "../include/generators.hpp"
+#include "../include/util.hpp"
+
+using namespace find_embedding;
+using std::vector;
+
+class split_layout {
+    vector<vector<int>> visited, parents, permutations;
+    vector<vector<distance_t>> distances;
+
+  public:
+    split_layout(int rows, const vector<vector<int>> &perms)
+            : visited(rows, vector<int>(perms[0].size())),
+              parents(visited),
+              permutations(perms),
+              distances(rows, vector<distance_t>(perms[0].size())) {}
+    inline int &visit(int v, int q) { return visited[v][q]; }
+    inline int &parent(int v, int q) { return parents[v][q]; }
+    inline int permutation(int v, int q) const { return permutations[v][q]; }
+    inline distance_t &distance(int v, int q) { return distances[v][q]; }
+};
+
+class packed_layout {
+    struct record {
+        distance_t distance;
+        int parent;
+        int visited;
+    };
+    vector<vector<record>> records;
+    vector<vector<int>> permutations;
+
+  public:
+    packed_layout(int rows, const vector<vector<int>> &perms)
+            : records(rows, vector<record>(perms[0].size())), permutations(perms) {}
+    inline int &visit(int v, int q) { return records[v][q].visited; }
+    inline int &parent(int v, int q) { return records[v][q].parent; }
+    inline int permutation(int v, int q) const { return permutations[v][q]; }
+    inline distance_t &distance(int v, int q) { return records[v][q].distance; }
+};
+
+class full_layout {
+    struct record {
+        distance_t distance;
+        int parent;
+        int visited;
+        int permutation;
+    };
+    vector<vector<record>> records;
+
+  public:
+    full_layout(int rows, const vector<vector<int>> &perms) : records(rows, vector<record>(perms[0].size())) {
+        for (size_t v = 0; v < perms.size(); v++)
+            for (size_t q = 0; q < perms[v].size(); q++) records[v][q].permutation = perms[v][q];
+    }
+    inline int &visit(int v, int q) { return records[v][q].visited; }
+    inline int &parent(int v, int q) { return records[v][q].parent; }
+    inline int permutation(int v, int q) const { return records[v][q].permutation; }
+    inline distance_t &distance(int v, int q) { return records[v][q].distance; }
+};
+
+struct workload {
+    vector<vector<int>> nbrs;
+    vector<fill_t> fill;
+    vector<distance_t> weight;
+    vector<vector<int>> permutations;
+    vector<int> roots;
+    int weight_bound = 2;
+};
+
+//! returns a checksum of the totals, so the work can't be optimized away
+template <typename layout_t>
+distance_t run(layout_t &layout, const workload &w, int rounds) {
+    const int num_qubits = w.nbrs.size(), rows = w.roots.size();
+    vector<distance_t> total(num_qubits);
+    distance_queue pq(num_qubits);
+    distance_t checksum = 0;
+    for (int r = 0; r < rounds; r++) {
+        std::fill(std::begin(total), std::end(total), 0);
+        for (int v = 0; v < rows; v++) {
+            for (int q = 0; q < num_qubits; q++) layout.visit(v, q) = 0;
+            int root = w.roots[(v + r) % rows];
+            pq.reset();
+            pq.emplace(root, layout.permutation(v, root), 0);
+            layout.visit(v, root) = 1;
+            layout.parent(v, root) = -1;
+            while (!pq.empty()) {
+                auto z = pq.top();
+                pq.pop();
+                layout.distance(v, z.node) = z.dist;
+                for (auto &p : w.nbrs[z.node]) {
+                    if (layout.visit(v, p)) continue;
+                    layout.visit(v, p) = 1;
+                    if (w.fill[p] >= w.weight_bound) {
+                        layout.distance(v, p) = max_distance;
+                    } else {
+                        layout.parent(v, p) = z.node;
+                        pq.emplace(p, layout.permutation(v, p), z.dist + w.weight[p]);
+                    }
+                }
+            }
+            for (int q = 0; q < num_qubits; q++) {
+                distance_t d = layout.distance(v, q);
+                if (layout.visit(v, q) == 1 && total[q] != max_distance && d != max_distance &&
+                    w.fill[q] < w.weight_bound)
+                    total[q] += d;
+                else
+                    total[q] = max_distance;
+            }
+        }
+        for (auto &t : total) checksum += (t == max_distance) ? 1 : t;
+    }
+    return checksum;
+}
+
+template <typename layout_t>
+void report(const char *name, const workload &w, int rounds) {
+    layout_t layout(w.roots.size(), w.permutations);
+    run(layout, w, 1);
+    auto start = std::chrono::steady_clock::now();
+    distance_t checksum = run(layout, w, rounds);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-8s %10.3f ms/round  (checksum %lld)\n", name, 1000 * seconds / rounds, checksum);
+}
+
+int main(int argc, char **argv) {
+    int m = argc > 1 ? atoi(argv[1]) : 16;
+    int rows = argc > 2 ? atoi(argv[2]) : 16;
+    int rounds = argc > 3 ? atoi(argv[3]) : 20;
+
+    graph::input_graph target = graph::pegasus(m);
+    workload w;
+    int num_qubits = target.num_nodes();
+    w.nbrs.resize(num_qubits);
+    for (int i = 0; i < target.num_edges(); i++) {
+        w.nbrs[target.a(i)].push_back(target.b(i));
+        w.nbrs[target.b(i)].push_back(target.a(i));
+    }
+    // a quarter of the qubits are already in use, and cost as much as an unused path of 64 qubits
+    fastrng rng(UINT64_C(1));
+    w.fill.resize(num_qubits);
+    w.weight.resize(num_qubits);
+    for (int q = 0; q < num_qubits; q++) {
+        w.fill[q] = (rng() & 3) == 0;
+        w.weight[q] = w.fill[q] ? 64 : 1;
+    }
+    vector<int> permutation(num_qubits);
+    std::iota(std::begin(permutation), std::end(permutation), 0);
+    for (int v = 0; v < rows; v++) {
+        for (int i = num_qubits; i > 1; i--) std::swap(permutation[i - 1], permutation[rng() % i]);
+        w.permutations.push_back(permutation);
+        int root;
+        do root = rng() % num_qubits;
+        while (w.nbrs[root].empty());
+        w.roots.push_back(root);
+    }
+
+    printf("pegasus(%d): %d qubits, %d rows, %d rounds\n", m, num_qubits, rows, rounds);
+    report<split_layout>("split", w, rounds);
+    report<packed_layout>("packed", w, rounds);
+    report<full_layout>("full", w, rounds);
+    return 0;
+}
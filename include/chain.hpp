@@ -1,5 +1,6 @@
 #pragma once
 #include <iostream>
+#include "node_pool.hpp"
 #include "util.hpp"
 
 namespace find_embedding {
@@ -42,10 +43,52 @@ namespace find_embedding {
 //!     `refs` is the total number of references to `qubit`, counting
 //!            both parents and links
 //!     the chain root is its own parent.
+//!
+//! Both maps draw their nodes from the `node_pool` given at construction, if
+//! any, which is shared by every chain of an embedding.
+
+//! moves qubits from the chain of `victim_label` into the chain of `thief_label`, as described in `chain::steal`.
+//! either side may be a `chain` or a chain-like scratch space, which lets `embedding` rebalance a chain against all
+//! of its neighbors while holding that chain on flat arrays
+template <typename thief_t, typename victim_t, typename embedding_problem_t>
+inline void steal_segment(thief_t &thief, const int thief_label, victim_t &victim, const int victim_label,
+                          embedding_problem_t &ep, const int chainsize) {
+    int q = thief.drop_link(victim_label);
+    int p = victim.drop_link(thief_label);
+
+    minorminer_assert(q != -1);
+    minorminer_assert(p != -1);
+
+    while ((chainsize == 0 || thief.size() < chainsize) && ep.accepts_qubit(thief_label, p)) {
+        int r = victim.trim_leaf(p);
+        minorminer_assert(victim.size() >= 1);
+        if (r == p) break;
+        if (!thief.count(p))
+            thief.add_leaf(p, q);
+        else if (p != q)
+            thief.trim_branch_to(q, p);
+        q = p;
+        p = r;
+    }
+
+    minorminer_assert(victim.count(p) == 1);
+    minorminer_assert(thief.count(q) == 1);
+
+    thief.set_link(victim_label, q);
+    victim.set_link(thief_label, p);
+}
+
+//! the maps which hold chain data and links, with nodes drawn from a `node_pool`
+using chain_data = unordered_map<int, pair<int, int>, std::hash<int>, std::equal_to<int>,
+                                 pool_allocator<pair<const int, pair<int, int>>>>;
+using chain_links = unordered_map<int, int, std::hash<int>, std::equal_to<int>, pool_allocator<pair<const int, int>>>;
 
 struct frozen_chain {
-    unordered_map<int, pair<int, int>> data;
-    unordered_map<int, int> links;
+    chain_data data;
+    chain_links links;
+    //! construct an empty frozen chain; `pool` must be the pool of the chains it will hold
+    frozen_chain(node_pool *pool = nullptr)
+            : data(chain_data::allocator_type(pool)), links(chain_links::allocator_type(pool)) {}
     void clear() {
         data.clear();
         links.clear();
@@ -54,9 +97,9 @@ struct frozen_chain {
 
 class chain {
   private:
-    vector<int> &qubit_weight;
-    unordered_map<int, pair<int, int>> data;
-    unordered_map<int, int> links;
+    vector<fill_t> &qubit_weight;
+    chain_data data;
+    chain_links links;
 #ifdef CPPDEBUG
     bool belay_diagnostic;
 #endif
@@ -65,8 +108,10 @@ class chain {
     const int label;
 
     //! construct this chain, linking it to the qubit_weight vector `w` (common to
-    //! all chains in an embedding, typically) and setting its variable label `l`
-    chain(vector<int> &w, int l) : qubit_weight(w), data(), links(), label(l) {
+    //! all chains in an embedding, typically) and setting its variable label `l`.
+    //! nodes are drawn from `pool` if one is given (see `node_pool`)
+    chain(vector<fill_t> &w, int l, node_pool *pool = nullptr)
+            : qubit_weight(w), data(chain_data::allocator_type(pool)), links(chain_links::allocator_type(pool)), label(l) {
 #ifdef CPPDEBUG
         belay_diagnostic = false;
 #endif
@@ -147,6 +192,25 @@ class chain {
         DIAGNOSE("set_root");
     }
 
+    //! assign this chain to a tree built elsewhere, rooted at `root`.  the `tree`
+    //! provides its `qubits()`, with their `parent(q)` and `refcount(q)` as in
+    //! `data`, and `links()`, each naming a variable `var` and the qubit `q` of
+    //! `tree` linking to it.  the qubits are inserted in bulk; the chains named by
+    //! the links must be linked back separately.  precondition: this is empty.
+    template <typename tree_t>
+    inline void assign_tree(const tree_t &tree, const int root) {
+        minorminer_assert(data.size() == 0);
+        minorminer_assert(links.size() == 0);
+        data.reserve(tree.size());
+        for (auto &q : tree.qubits()) {
+            data.emplace(q, pair<int, int>(tree.parent(q), tree.refcount(q)));
+            qubit_weight[q]++;
+        }
+        links.emplace(label, root);
+        for (auto &l : tree.links()) links.emplace(l.var, l.q);
+        DIAGNOSE("assign_tree");
+    }
+
     //! empty this data structure
     inline void clear() {
         for (auto &q : *this) qubit_weight[q]--;
@@ -180,6 +244,21 @@ class chain {
         return q;
     }
 
+    //! as `trim_branch(q)`, but stop at `p`, which is an ancestor of `q` that is kept
+    //! in the chain
+    inline void trim_branch_to(const int q, const int p) {
+        auto &w = retrieve(p);
+        w.second++;
+#ifdef CPPDEBUG
+        belay_diagnostic = true;
+#endif
+        trim_branch(q);
+#ifdef CPPDEBUG
+        belay_diagnostic = false;
+#endif
+        w.second--;
+    }
+
     //! try to delete the qubit `q` from this chain.  if `q`
     //! cannot be deleted, return it; otherwise return its parent
     inline int trim_leaf(int q) {
@@ -248,6 +327,25 @@ class chain {
         return keep.data.size();
     }
 
+    //! copy this chain and its own links into `keep`, leaving the chains
+    //! linked to this alone
+    inline void save(frozen_chain &keep) const {
+        keep.clear();
+        for (auto &z : data) keep.data.emplace(z);
+        for (auto &z : links) keep.links.emplace(z);
+    }
+
+    //! replace this chain and its own links with a copy taken by `save`.
+    //! the links that other chains hold into this are left alone, so they
+    //! must agree with the copy
+    inline void restore(frozen_chain &keep) {
+        for (auto &q : *this) qubit_weight[q]--;
+        data.swap(keep.data);
+        links.swap(keep.links);
+        for (auto &q : *this) qubit_weight[q]++;
+        DIAGNOSE("restore");
+    }
+
     //! restore a `frozen_chain` into this, re-establishing links
     //! from other chains.  precondition: this is empty.
     inline void thaw(vector<chain> &others, frozen_chain &keep) {
@@ -273,40 +371,7 @@ class chain {
     //! links after all
     template <typename embedding_problem_t>
     inline void steal(chain &other, embedding_problem_t &ep, int chainsize = 0) {
-        int q = drop_link(other.label);
-        int p = other.drop_link(label);
-
-        minorminer_assert(q != -1);
-        minorminer_assert(p != -1);
-
-        while ((chainsize == 0 || size() < chainsize) && ep.accepts_qubit(label, p)) {
-            int r = other.trim_leaf(p);
-            minorminer_assert(other.size() >= 1);
-            if (r == p) break;
-            auto z = data.find(p);
-            if (z == data.end())
-                add_leaf(p, q);
-            else if (p != q) {
-                auto &w = (*z).second;
-                w.second++;
-#ifdef CPPDEBUG
-                belay_diagnostic = true;
-#endif
-                trim_branch(q);
-#ifdef CPPDEBUG
-                belay_diagnostic = false;
-#endif
-                w.second--;
-            }
-            q = p;
-            p = r;
-        }
-
-        minorminer_assert(other.count(p) == 1);
-        minorminer_assert(count(q) == 1);
-
-        set_link(other.label, q);
-        other.set_link(label, p);
+        steal_segment(*this, label, other, other.label, ep, chainsize);
         DIAGNOSE2(other, "steal");
     }
 
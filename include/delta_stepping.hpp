@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "util.hpp"
+
+namespace find_embedding {
+
+//! Parallel single-source shortest paths on node-weighted graphs by delta-stepping (Meyer & Sanders).  Tentative
+//! distances are grouped into buckets of width `delta`; in each round, the threads settle the lowest nonempty bucket
+//! together, relaxing the neighbors of its nodes with an atomic minimum.  A node `p` entered from `q` has distance
+//! `distance(q) + weight[p]`, which matches the convention of `compute_distances_from_chain`.
+//!
+//! Only distances are computed here.  Parents depend on the order in which nodes are settled, which isn't
+//! reproducible between threads, so callers recover them afterwards (see the `finish` argument of `run`).
+template <typename distance_t>
+class basic_delta_stepping {
+  public:
+    using entry = std::pair<int, distance_t>;
+    static constexpr distance_t max_distance = numeric_limits<distance_t>::max();
+
+  private:
+    int num_threads;
+    vector<std::atomic<distance_t>> tentative;
+    vector<vector<entry>> pending;
+    vector<vector<entry>> fresh;
+    vector<std::future<void>> futures;
+    spin_barrier barrier;
+    //! one slot per thread for reductions; double-buffered so that a slot is never overwritten before it's read
+    vector<distance_t> reduce[2];
+
+  public:
+    basic_delta_stepping(int num_nodes, int threads)
+            : num_threads(max(threads, 1)),
+              tentative(num_nodes),
+              pending(num_threads),
+              fresh(num_threads),
+              futures(num_threads),
+              barrier(num_threads),
+              reduce{vector<distance_t>(num_threads), vector<distance_t>(num_threads)} {}
+
+    //! the distance computed for `q` by the last call to `run`, or `max_distance` if `q` was not reached
+    inline distance_t distance(int q) const { return tentative[q].load(std::memory_order_relaxed); }
+
+    //! compute distances from `sources`, a list of nodes paired with their initial distances.  only nodes for which
+    //! `relaxable(p)` holds are entered by the search; sources are expanded regardless, and their distances are never
+    //! improved.  nodes are neither entered nor expanded beyond `radius`, so a node further than that keeps
+    //! `max_distance`, and a source keeps its initial distance.  once every distance is final, `finish(a, b)` is called
+    //! by each thread on a disjoint range of nodes covering `[0, num_nodes)`
+    template <typename neighbors_t, typename relaxable_t, typename finish_t>
+    void run(neighbors_t neighbors, relaxable_t relaxable, const vector<distance_t> &weight,
+             const vector<entry> &sources, const distance_t delta, finish_t finish,
+             const distance_t radius = max_distance) {
+        auto body = [&, this](int t) {
+            run_in_thread(t, neighbors, relaxable, weight, sources, delta, finish, radius);
+        };
+        for (int t = 1; t < num_threads; t++) futures[t] = std::async(std::launch::async, body, t);
+        body(0);
+        for (int t = 1; t < num_threads; t++) futures[t].wait();
+    }
+
+  private:
+    template <typename relaxable_t, typename neighbors_t>
+    inline void expand(vector<entry> &out, neighbors_t &neighbors, relaxable_t &relaxable,
+                       const vector<distance_t> &weight, const int q, const distance_t d, const distance_t radius) {
+        for (auto &p : neighbors(q)) {
+            if (!relaxable(p)) continue;
+            distance_t dp = d + weight[p];
+            if (dp > radius) continue;
+            distance_t cur = tentative[p].load(std::memory_order_relaxed);
+            while (dp < cur) {
+                if (tentative[p].compare_exchange_weak(cur, dp, std::memory_order_relaxed)) {
+                    out.emplace_back(p, dp);
+                    break;
+                }
+            }
+        }
+    }
+
+    //! a pending entry is stale if its node has since been reached by a shorter path
+    inline bool stale(const entry &e) const { return e.second != distance(e.first); }
+
+    template <typename neighbors_t, typename relaxable_t, typename finish_t>
+    void run_in_thread(const int t, neighbors_t &neighbors, relaxable_t &relaxable, const vector<distance_t> &weight,
+                       const vector<entry> &sources, const distance_t delta, finish_t &finish,
+                       const distance_t radius) {
+        const int n = tentative.size();
+        const int a = static_cast<long long>(n) * t / num_threads;
+        const int b = static_cast<long long>(n) * (t + 1) / num_threads;
+        auto &mine = pending[t];
+        auto &next = fresh[t];
+        mine.clear();
+        for (int q = a; q < b; q++) tentative[q].store(max_distance, std::memory_order_relaxed);
+        barrier.wait();
+
+        for (size_t i = t; i < sources.size(); i += num_threads) {
+            const int q = sources[i].first;
+            const distance_t d = sources[i].second;
+            distance_t cur = tentative[q].load(std::memory_order_relaxed);
+            while (d < cur) {
+                if (tentative[q].compare_exchange_weak(cur, d, std::memory_order_relaxed)) {
+                    if (d <= radius) mine.emplace_back(q, d);
+                    break;
+                }
+            }
+        }
+
+        int phase = 0;
+        barrier.wait();
+        while (1) {
+            // find the lowest nonempty bucket
+            distance_t lo = max_distance;
+            for (auto &e : mine)
+                if (e.second < lo && !stale(e)) lo = e.second;
+            reduce[phase & 1][t] = lo;
+            barrier.wait();
+            lo = *std::min_element(std::begin(reduce[phase & 1]), std::end(reduce[phase & 1]));
+            phase++;
+            if (lo == max_distance) break;
+
+            const distance_t limit = bucket_end(lo, delta);
+            while (1) {
+                // expand the entries in the current bucket; entries of later buckets are kept for later rounds
+                next.clear();
+                size_t kept = 0;
+                for (size_t i = 0; i < mine.size(); i++) {
+                    entry e = mine[i];
+                    if (stale(e)) continue;
+                    if (e.second < limit)
+                        expand(next, neighbors, relaxable, weight, e.first, e.second, radius);
+                    else
+                        mine[kept++] = e;
+                }
+                mine.resize(kept);
+                distance_t more = 0;
+                for (auto &e : next) {
+                    if (e.second < limit) more = 1;
+                    mine.push_back(e);
+                }
+                // weights below `delta` can land new entries in the current bucket, which we settle before moving on
+                reduce[phase & 1][t] = more;
+                barrier.wait();
+                more = *std::max_element(std::begin(reduce[phase & 1]), std::end(reduce[phase & 1]));
+                phase++;
+                if (!more) break;
+            }
+        }
+        finish(a, b);
+    }
+};
+
+template <typename distance_t>
+constexpr distance_t basic_delta_stepping<distance_t>::max_distance;
+
+using delta_stepping = basic_delta_stepping<distance_t>;
+}
@@ -20,6 +20,177 @@ namespace find_embedding {
 #define DIAGNOSE(X)
 #endif
 
+//! Scratch space for trying out chains on flat arrays, without touching an
+//! embedding.  It mirrors the qubit-use accounting of the chain class: each
+//! member qubit has a parent and a reference count.  Membership is tracked
+//! with generation stamps, so that `reset` is cheap.  A finished tree can be
+//! moved into a chain in bulk, with `chain::assign_tree`.
+class steiner_scratch {
+  public:
+    //! a link from qubit `q` of the scratch chain, to qubit `p` in the chain of `var`
+    struct link {
+        int var;
+        int q;
+        int p;
+    };
+
+  private:
+    vector<int> stamp;
+    vector<int> parents;
+    vector<int> refs;
+    vector<int> position;
+    vector<int> members;
+    vector<link> link_list;
+    int generation;
+
+  public:
+    steiner_scratch() : stamp(), parents(), refs(), position(), members(), link_list(), generation(0) {}
+
+    //! empty the scratch chain, making room for qubits labeled up to `n`
+    void reset(int n) {
+        if (static_cast<int>(stamp.size()) < n) {
+            stamp.resize(n, 0);
+            parents.resize(n);
+            refs.resize(n);
+            position.resize(n);
+        }
+        if (++generation == std::numeric_limits<int>::max()) {
+            std::fill(std::begin(stamp), std::end(stamp), 0);
+            generation = 1;
+        }
+        members.clear();
+        link_list.clear();
+    }
+
+    inline int size() const { return members.size(); }
+    inline bool count(int q) const { return stamp[q] == generation; }
+    inline int parent(int q) const { return parents[q]; }
+    inline int refcount(int q) const { return refs[q]; }
+    inline const vector<int> &qubits() const { return members; }
+    inline const vector<link> &links() const { return link_list; }
+
+    //! as `chain::set_root`
+    inline void set_root(int q) {
+        insert(q, q, 2);
+    }
+
+    //! as `chain::add_leaf`
+    inline void add_leaf(int q, int p) {
+        insert(q, p, 0);
+        refs[p]++;
+    }
+
+    //! as `chain::set_link`, where `p` is the qubit at the other end of the link
+    inline void set_link(int var, int q, int p) {
+        refs[q]++;
+        link_list.push_back(link{var, q, p});
+    }
+
+    //! as `chain::set_link`
+    inline void set_link(int var, int q) { set_link(var, q, -1); }
+
+    //! as `chain::drop_link`
+    inline int drop_link(int var) {
+        for (auto &l : link_list) {
+            if (l.var == var) {
+                int q = l.q;
+                refs[q]--;
+                l = link_list.back();
+                link_list.pop_back();
+                return q;
+            }
+        }
+        return -1;
+    }
+
+    //! as `chain::trim_branch_to`
+    inline void trim_branch_to(int q, int p) {
+        refs[p]++;
+        trim_branch(q);
+        refs[p]--;
+    }
+
+    //! load a copy of the chain `c`, with its links to the variables `vars`, making room
+    //! for qubits labeled up to `n`
+    template <typename vars_t>
+    void load(const chain &c, const vars_t &vars, int n) {
+        reset(n);
+        for (auto &q : c) insert(q, c.parent(q), c.refcount(q));
+        for (auto &v : vars) {
+            int q = c.get_link(v);
+            if (q >= 0) link_list.push_back(link{v, q, -1});
+        }
+    }
+
+    //! as `chain::trim_branch`
+    inline int trim_branch(int q) {
+        int p = trim_leaf(q);
+        while (p != q) {
+            q = p;
+            p = trim_leaf(q);
+        }
+        return q;
+    }
+
+    //! as `chain::trim_leaf`
+    inline int trim_leaf(int q) {
+        if (refs[q] == 0) {
+            int p = parents[q];
+            refs[p]--;
+            erase(q);
+            return p;
+        }
+        return q;
+    }
+
+  private:
+    inline void insert(int q, int p, int r) {
+        stamp[q] = generation;
+        parents[q] = p;
+        refs[q] = r;
+        position[q] = members.size();
+        members.push_back(q);
+    }
+
+    inline void erase(int q) {
+        stamp[q] = 0;
+        int last = members.back();
+        members[position[q]] = last;
+        position[last] = position[q];
+        members.pop_back();
+    }
+};
+
+//! An index from each qubit to the variables whose chains hold it, stored in
+//! compressed rows.  Chains rarely overlap, so the rows are short, and asking
+//! whether a chain holds a qubit scans a few ints instead of probing the hash
+//! map of the chain.  The index is a snapshot: it is not updated as the chains
+//! change.
+class qubit_owners {
+  private:
+    vector<int> offset;
+    vector<int> owners;
+
+  public:
+    //! index the `chains`, whose qubits are labeled below `num_qubits`
+    qubit_owners(const vector<chain> &chains, int num_qubits) : offset(num_qubits + 1, 0), owners() {
+        for (auto &c : chains)
+            for (auto &q : c) offset[q + 1]++;
+        for (int q = 0; q < num_qubits; q++) offset[q + 1] += offset[q];
+        owners.resize(offset[num_qubits]);
+        vector<int> fill(std::begin(offset), std::end(offset) - 1);
+        for (auto &c : chains)
+            for (auto &q : c) owners[fill[q]++] = c.label;
+    }
+
+    //! the variables whose chains hold `q`
+    inline const int *begin(int q) const { return owners.data() + offset[q]; }
+    inline const int *end(int q) const { return owners.data() + offset[q + 1]; }
+
+    //! true if the chain of `v` holds `q`
+    inline bool owns(int v, int q) const { return std::find(begin(q), end(q), v) != end(q); }
+};
+
 //! This class is how we represent and manipulate embedding objects, using as
 //! much encapsulation as possible.  We provide methods to view and modify
 //! chains.
@@ -30,6 +201,9 @@ class embedding {
     char *last_diagnostic;
 #endif
   private:
+    using distance_t = typename embedding_problem_t::distance_t;
+    static constexpr distance_t max_distance = numeric_limits<distance_t>::max();
+
     embedding_problem_t &ep;
     int num_qubits, num_reserved;
     int num_vars, num_fixed;
@@ -37,13 +211,26 @@ class embedding {
     //! weights, that is, the number of non-fixed chains that use each qubit
     //! this is used in pathfinder clases to determine non-overlapped, or
     //! or least-overlapped paths through the qubit graph
-    vector<int> qub_weight;
+    vector<fill_t> qub_weight;
+
+    //! the nodes of every chain below, frozen or not, are drawn from this pool.  it is
+    //! declared first so that it outlives them
+    node_pool pool;
 
     //! this is where we store chains -- see chain.hpp for how
     vector<chain> var_embedding;
 
     frozen_chain frozen;
 
+    //! a stack of frozen chains, for moves that remove several chains at once; see
+    //! `freeze_push`.  slots above `frozen_depth` are kept for reuse.  a label `-v-1`
+    //! marks a copy of the chain for `v`, saved by `journal(v)`, which wasn't removed
+    vector<frozen_chain> frozen_stack;
+    vector<int> frozen_labels;
+    int frozen_depth;
+    //! set from the first `freeze_mark` until the freeze stack is emptied again
+    bool journaling;
+
   public:
     //! constructor for an empty embedding
     embedding(embedding_problem_t &e_p)
@@ -57,9 +244,15 @@ class embedding {
               num_vars(ep.num_vars()),
               num_fixed(ep.num_fixed()),
               qub_weight(num_qubits + num_reserved, 0),
+              pool(),
               var_embedding(),
-              frozen() {
-        for (int q = 0; q < num_vars + num_fixed; q++) var_embedding.emplace_back(qub_weight, q);
+              frozen(&pool),
+              frozen_stack(),
+              frozen_labels(),
+              frozen_depth(0),
+              journaling(false) {
+        var_embedding.reserve(num_vars + num_fixed);
+        for (int q = 0; q < num_vars + num_fixed; q++) var_embedding.emplace_back(qub_weight, q, &pool);
         DIAGNOSE("post base_construct");
     }
 
@@ -72,14 +265,35 @@ class embedding {
 
         for (auto &vC : fixed_chains) fix_chain(vC.first, vC.second);
 
-        for (auto &vC : initial_chains)
-            if (!ep.fixed(vC.first)) set_chain(vC.first, vC.second);
+        // an initial chain which would stack more than `max_fill_count` chains on a qubit is left for the
+        // initialization pass to place, and the user is told
+        for (auto &vC : initial_chains) {
+            if (ep.fixed(vC.first)) continue;
+            auto full = std::find_if(std::begin(vC.second), std::end(vC.second),
+                                     [this](int q) { return qub_weight[q] >= max_fill_count; });
+            if (full != std::end(vC.second)) {
+                ep.major_info("initial chain for %d dropped: qubit %d already holds %d chains\n", vC.first, *full,
+                              max_fill_count);
+                continue;
+            }
+            set_chain(vC.first, vC.second);
+        }
+
+        // chains are walked and linked through an index of the qubits they hold, so that this takes time linear in
+        // the sizes of the chains
+        qubit_owners owners(var_embedding, num_qubits + num_reserved);
 
+        // `active` marks the variables whose chains are linked to their neighbors; `reached` holds the last chain
+        // whose walk reached each qubit
+        vector<int> active(num_vars + num_fixed, 0), reached(num_qubits + num_reserved, -1);
         for (auto &vC : initial_chains) {
             int v = vC.first;
             auto &c = var_embedding[v];
+            if (!ep.fixed(v) && !c.size()) continue;
+            active[v] = 1;
             int root = vC.second[0];
             c.set_link(v, root);
+            reached[root] = v;
             int hits = 0;
             stack.push_back(root);
             while (stack.size()) {
@@ -87,21 +301,26 @@ class embedding {
                 int p = stack.back();
                 stack.pop_back();
                 for (auto &q : ep.qubit_neighbors(p))
-                    if (q != root && c.count(q) && c.parent(q) == q) {
+                    if (reached[q] != v && owners.owns(v, q)) {
+                        reached[q] = v;
                         c.adopt(p, q);
                         stack.push_back(q);
                     }
             }
             if (hits != c.size()) c.drop_link(v);
-            for (auto &u : ep.var_neighbors(v))
-                if (u > v) linkup(v, u);
         }
+        link_all(owners, active);
         DIAGNOSE("post construct");
     }
 
-    //! copy the data from `other.var_embedding` into `this.var_embedding`
+    //! copy the data from `other.var_embedding` into `this.var_embedding`.  chains
+    //! on the freeze stack of `this` are discarded
     embedding<embedding_problem_t> &operator=(const embedding<embedding_problem_t> &other) {
-        if (this != &other) var_embedding = other.var_embedding;
+        if (this != &other) {
+            var_embedding = other.var_embedding;
+            frozen_depth = 0;
+            journaling = false;
+        }
         DIAGNOSE("operator=");
         return *this;
     }
@@ -180,40 +399,134 @@ class embedding {
     //! we pick a nearest Steiner node, `qw`, from the current chain of `u`, and add
     //! the path starting at `qw`, similar to the above...
     //!    `qw` -> `parents[w][qw]` -> ...
-    //! this has an opportunity to make shorter chains than `construct_chain`
+    //! this has an opportunity to make shorter chains than `construct_chain`.  ties between
+    //! Steiner nodes are broken by qubit label, so the chain doesn't depend on the order in
+    //! which the chain's hash table is iterated.  the tree is built in `scratch`, and then
+    //! moved into the chain for `u` all at once
     void construct_chain_steiner(const int u, const int q, const vector<vector<int>> &parents,
-                                 const vector<vector<distance_t>> &distances, vector<vector<int>> &visited_list) {
-        var_embedding[u].set_root(q);
+                                 const vector<vector<distance_t>> &distances, const vector<vector<int>> &visited_list,
+                                 steiner_scratch &scratch) {
+        build_steiner(u, q, parents, distances, visited_list, scratch);
+        var_embedding[u].assign_tree(scratch, q);
+        for (auto &l : scratch.links()) var_embedding[l.var].set_link(u, l.p);
+        DIAGNOSE("construct_chain_steiner")
+    }
+
+    //! as above, with a scratch space of its own
+    void construct_chain_steiner(const int u, const int q, const vector<vector<int>> &parents,
+                                 const vector<vector<distance_t>> &distances, const vector<vector<int>> &visited_list) {
+        steiner_scratch scratch;
+        construct_chain_steiner(u, q, parents, distances, visited_list, scratch);
+    }
+
+    //! compute the size of the chain that `construct_chain_steiner(u, q, ...)` would build,
+    //! using `scratch` in place of the chain for `u`.  this embedding isn't modified, so
+    //! candidate roots can be evaluated concurrently, given a scratch space per thread.  the
+    //! chain for `u` is expected to be empty
+    int chainsize_steiner(const int u, const int q, const vector<vector<int>> &parents,
+                          const vector<vector<distance_t>> &distances, const vector<vector<int>> &visited_list,
+                          steiner_scratch &scratch) const {
+        build_steiner(u, q, parents, distances, visited_list, scratch);
+        return scratch.size();
+    }
+
+  private:
+    //! true if the first step of `steal_segment` would move a qubit from the chain of `victim` into the chain of
+    //! `thief`: the victim's link to the thief must be a leaf held by nothing but that link, and acceptable to the
+    //! thief.  the first step needs nothing else, so when this fails, `steal_segment` would leave both chains as they
+    //! are.  the two chains must be linked to eachother
+    bool can_steal(const int thief, const int victim, const int chainsize) const {
+        const chain &c = var_embedding[victim];
+        int p = c.get_link(thief);
+        minorminer_assert(p != -1);
+        return (chainsize == 0 || var_embedding[thief].size() < chainsize) && c.refcount(p) == 1 &&
+               ep.accepts_qubit(thief, p);
+    }
+
+    //! replace the chain for `u` with the copy held in `scratch`, keeping its root
+    void store(const int u, const steiner_scratch &scratch) {
+        int root = var_embedding[u].get_link(u);
+        var_embedding[u].clear();
+        var_embedding[u].assign_tree(scratch, root);
+    }
+
+    //! build the chain described in `construct_chain_steiner` in `scratch`, following
+    //! `chain::link_path` for each neighbor
+    void build_steiner(const int u, const int q, const vector<vector<int>> &parents,
+                       const vector<vector<distance_t>> &distances, const vector<vector<int>> &visited_list,
+                       steiner_scratch &scratch) const {
+        scratch.reset(num_qubits + num_reserved);
+        scratch.set_root(q);
         for (auto &v : ep.var_neighbors(u)) {
-            if (chainsize(v)) {
-                int qv = q;
-                distance_t dqv = visited_list[v][q] ? distances[v][q] : max_distance;
-                for (auto &p : var_embedding[u]) {
-                    if (var_embedding[u].refcount(p) > 1) {
-                        distance_t dp = visited_list[v][p] ? distances[v][p] : max_distance;
-                        if (dp < dqv) {
-                            dqv = dp;
-                            qv = p;
-                        }
+            if (!chainsize(v)) continue;
+            const vector<int> &visited = visited_list[v];
+            const vector<distance_t> &distance = distances[v];
+            int qv = q;
+            distance_t dqv = (visited[q] == 1) ? distance[q] : max_distance;
+            for (auto &p : scratch.qubits()) {
+                if (scratch.refcount(p) > 1) {
+                    distance_t dp = (visited[p] == 1) ? distance[p] : max_distance;
+                    if (dp < dqv || (dp == dqv && p < qv)) {
+                        dqv = dp;
+                        qv = p;
                     }
                 }
-                var_embedding[u].link_path(var_embedding[v], qv, parents[v]);
             }
+            const chain &other = var_embedding[v];
+            const vector<int> &parent = parents[v];
+            int p = parent[qv];
+            if (p == -1) {
+                p = qv;
+            } else {
+                while (other.count(p) == 0) {
+                    if (scratch.count(p))
+                        scratch.trim_branch(qv);
+                    else
+                        scratch.add_leaf(p, qv);
+                    qv = p;
+                    p = parent[p];
+                }
+            }
+            scratch.set_link(v, qv, p);
         }
-        DIAGNOSE("construct_chain_steiner")
     }
 
+  public:
     //! distribute path segments to the neighboring chains -- path segments are the qubits
     //! that are ONLY used to join link_qubit[u][v] to link_qubit[u][u] and aren't used
     //! for any other variable
     //!  * if the target chainsize is zero, dump the entire segment into the neighbor
     //!  * if the target chainsize is k, stop when the neighbor's size reaches k
-    void flip_back(int u, const int target_chainsize) {
-        for (auto &v : ep.var_neighbors(u))
-            if (chainsize(v) && !(ep.fixed(v))) var_embedding[v].steal(var_embedding[u], ep, target_chainsize);
+    //! the chain for `u` is held in `scratch` while the neighbors take their segments from it, in turn, and written
+    //! back once at the end.  it's only loaded once some neighbor has a qubit to take, so that when nothing moves,
+    //! each neighbor costs a few lookups, as it did with `chain::steal`
+    void flip_back(int u, const int target_chainsize, steiner_scratch &scratch) {
+        if (!chainsize(u)) return;
+        bool loaded = false;
+        for (auto &v : ep.var_neighbors(u)) {
+            if (chainsize(v) && !(ep.fixed(v))) {
+                if (!loaded) {
+                    if (!can_steal(v, u, target_chainsize)) continue;
+                    scratch.load(var_embedding[u], ep.var_neighbors(u), num_qubits + num_reserved);
+                    loaded = true;
+                }
+                journal(v);
+                steal_segment(var_embedding[v], v, scratch, u, ep, target_chainsize);
+            }
+        }
+        if (loaded) {
+            journal(u);
+            store(u, scratch);
+        }
         DIAGNOSE("flip_back")
     }
 
+    //! as above, with a scratch space of its own
+    void flip_back(int u, const int target_chainsize) {
+        steiner_scratch scratch;
+        flip_back(u, target_chainsize, scratch);
+    }
+
     //! short tearout procedure
     //! blank out the chain, its linking qubits, and account for the qubits being freed
     void tear_out(int u) {
@@ -244,17 +557,103 @@ class embedding {
         DIAGNOSE("thaw_back")
     }
 
-    //! grow the chain for `u`, stealing all available qubits from neighboring variables
-    void steal_all(int u) {
+    //! the current depth of the freeze stack, to be passed to `thaw_to` or `commit_to`.
+    //! from the first mark until the stack is emptied, `steal_all` and `flip_back` save
+    //! each chain they change on the stack, so that `thaw_to` can undo them as well
+    inline int freeze_mark() {
+        journaling = true;
+        return frozen_depth;
+    }
+
+    //! a tearout procedure which can be undone along with others: the chain for `u` is
+    //! pushed onto the freeze stack, unlike `freeze_out(u)`, which has a single slot.
+    //! a compound move takes a mark, pushes each chain it removes, and places new
+    //! chains; then it either keeps them with `commit_to(mark)` or rolls back with
+    //! `thaw_to(mark)`.  the only other chains it may change in the meantime are those
+    //! changed by `steal_all` and `flip_back`.  returns the size of the chain being frozen
+    int freeze_push(int u) {
+        int size = var_embedding[u].freeze(var_embedding, push_slot(u));
+        DIAGNOSE("freeze_push")
+        return size;
+    }
+
+    //! undo every change since `mark`, newest first: chains placed for the variables
+    //! pushed since then are torn out and the frozen chains thawed, and the chains saved
+    //! by `steal_all` and `flip_back` are restored.  the frozen chains are restored in
+    //! reverse order, so that their links to eachother are restored as well
+    void thaw_to(int mark) {
+        minorminer_assert(0 <= mark && mark <= frozen_depth);
+        while (frozen_depth > mark) {
+            frozen_depth--;
+            int u = frozen_labels[frozen_depth];
+            if (u < 0) {
+                var_embedding[-u - 1].restore(frozen_stack[frozen_depth]);
+            } else {
+                if (chainsize(u)) tear_out(u);
+                var_embedding[u].thaw(var_embedding, frozen_stack[frozen_depth]);
+            }
+        }
+        journaling = frozen_depth > 0;
+        DIAGNOSE("thaw_to")
+    }
+
+    //! keep every change since `mark`, discarding the chains frozen by `freeze_push`
+    //! since then.  their slots are recycled by later pushes, so this takes constant time
+    inline void commit_to(int mark) {
+        minorminer_assert(0 <= mark && mark <= frozen_depth);
+        frozen_depth = mark;
+        journaling = frozen_depth > 0;
+    }
+
+  private:
+    //! the next slot of the freeze stack, for the chain of `u` (or a copy of it, if
+    //! `u` is negative)
+    frozen_chain &push_slot(int u) {
+        if (frozen_depth == static_cast<int>(frozen_stack.size())) {
+            frozen_stack.emplace_back(&pool);
+            frozen_labels.push_back(u);
+        }
+        frozen_labels[frozen_depth] = u;
+        return frozen_stack[frozen_depth++];
+    }
+
+    //! while a mark is held, save a copy of the chain for `v`, which is about to change
+    inline void journal(int v) {
+        if (journaling) var_embedding[v].save(push_slot(-v - 1));
+    }
+
+  public:
+
+    //! grow the chain for `u`, stealing all available qubits from neighboring variables.
+    //! as in `flip_back`, the chain for `u` is held in `scratch` meanwhile, from the first
+    //! neighbor with a qubit to give
+    void steal_all(int u, steiner_scratch &scratch) {
+        bool loaded = false;
         for (auto &v : ep.var_neighbors(u)) {
             if (ep.fixed(v)) continue;
             if (var_embedding[u].get_link(v) == -1) continue;
             if (var_embedding[v].get_link(u) == -1) continue;
-            var_embedding[u].steal(var_embedding[v], ep);
+            if (!loaded) {
+                if (!can_steal(u, v, 0)) continue;
+                scratch.load(var_embedding[u], ep.var_neighbors(u), num_qubits + num_reserved);
+                loaded = true;
+            }
+            journal(v);
+            steal_segment(scratch, u, var_embedding[v], v, ep, 0);
+        }
+        if (loaded) {
+            journal(u);
+            store(u, scratch);
         }
         DIAGNOSE("steal_all")
     }
 
+    //! as above, with a scratch space of its own
+    void steal_all(int u) {
+        steiner_scratch scratch;
+        steal_all(u, scratch);
+    }
+
     //! compute statistics for this embedding and return `1` if no chains are overlapping
     //! when no chains are overlapping, populate `stats` with a chainlength histogram
     //! chains do overlap, populate `stats` with a qubit overfill histogram
@@ -302,29 +701,63 @@ class embedding {
     }
 
   private:
-    //! This method attempts to find the linking qubits for a pair of adjacent variables, and
-    //! returns true/false on success/failure in finding that pair.
-    bool linkup(int u, int v) {
-        if ((var_embedding[u].get_link(v) >= 0) && (var_embedding[v].get_link(u) >= 0)) {
-            return true;
-        }
-        for (auto &q : var_embedding[v]) {  // hax!  this plays nicely with reserved qubits being sources
-            for (auto &p : ep.qubit_neighbors(q)) {
-                if (has_qubit(u, p)) {
-                    var_embedding[u].set_link(v, p);
-                    var_embedding[v].set_link(u, q);
-                    return true;
+    //! Links each variable `w` marked in `active` to each of its neighbors `u > w`, where the chains allow.  As
+    //! reserved qubits only have outbound edges, the link for a pair is found from the chain of `u`, as the first
+    //! qubit `q` of that chain with a neighbor `p` held by `w`; failing that, the chains are linked at the first
+    //! qubit of `w` which they share.  Each chain is walked once for each of those steps, so this takes time linear in
+    //! the sizes of the chains, and their neighborhoods in the qubit graph.
+    void link_all(const qubit_owners &owners, const vector<int> &active) {
+        // the pairs are found from the side of `w`, as fixed variables have no outbound edges.  `wanted[w] == u`
+        // while the pair (w, u) awaits a link
+        vector<vector<int>> partners(num_vars + num_fixed);
+        for (int w = 0; w < num_vars + num_fixed; w++)
+            if (active[w])
+                for (auto &u : ep.var_neighbors(w))
+                    if (u > w && unlinked(w, u)) partners[u].push_back(w);
+        vector<int> wanted(num_vars + num_fixed, -1);
+        for (int u = 0; u < num_vars + num_fixed; u++) {
+            auto &c = var_embedding[u];
+            int pending = partners[u].size();
+            for (auto &w : partners[u]) wanted[w] = u;
+            for (auto q = c.begin(); pending && q != c.end(); ++q) {
+                for (auto &p : ep.qubit_neighbors(*q)) {
+                    for (auto w = owners.begin(p); w != owners.end(p); ++w) {
+                        if (wanted[*w] == u) {
+                            var_embedding[*w].set_link(u, p);
+                            c.set_link(*w, *q);
+                            wanted[*w] = -1;
+                            pending--;
+                        }
+                    }
                 }
             }
         }
-        for (auto &q : var_embedding[u]) {
-            if (has_qubit(v, q)) {
-                var_embedding[u].set_link(v, q);
-                var_embedding[v].set_link(u, q);
-                return true;
+        std::fill(std::begin(wanted), std::end(wanted), -1);
+        for (int w = 0; w < num_vars + num_fixed; w++) {
+            if (!active[w]) continue;
+            auto &c = var_embedding[w];
+            int pending = 0;
+            for (auto &u : ep.var_neighbors(w))
+                if (u > w && unlinked(w, u)) {
+                    wanted[u] = w;
+                    pending++;
+                }
+            for (auto q = c.begin(); pending && q != c.end(); ++q) {
+                for (auto u = owners.begin(*q); u != owners.end(*q); ++u) {
+                    if (wanted[*u] == w) {
+                        c.set_link(*u, *q);
+                        var_embedding[*u].set_link(w, *q);
+                        wanted[*u] = -1;
+                        pending--;
+                    }
+                }
             }
         }
-        return false;
+    }
+
+    //! true unless the chains of `u` and `v` are already linked to one another
+    inline bool unlinked(int u, int v) const {
+        return var_embedding[u].get_link(v) < 0 || var_embedding[v].get_link(u) < 0;
     }
 
   public:
@@ -540,4 +973,7 @@ class embedding {
         }
     }
 };
+
+template <typename embedding_problem_t>
+constexpr typename embedding<embedding_problem_t>::distance_t embedding<embedding_problem_t>::max_distance;
 }
\ No newline at end of file
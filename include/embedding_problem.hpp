@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <future>
 #include <limits>
 #include <map>
 #include <random>
@@ -16,7 +17,8 @@ namespace find_embedding {
 enum VARORDER { VARORDER_SHUFFLE, VARORDER_DFS, VARORDER_BFS, VARORDER_PFS, VARORDER_RPFS, VARORDER_KEEP };
 
 // This file contains component classes for constructing embedding problems.  Presently, an embedding_problem class is
-// constructed by combining the embedding_problem_base class with a domain_handler class and a fixed_handler class.
+// constructed by combining the embedding_problem_base class with a domain_handler class, a fixed_handler class, an
+// output_handler class and a weight_handler class.
 // This is used to accomplish dynamic dispatch for code in/around the inner loops without fouling their performance.
 
 // Domain handlers are used to control which qubits are available for use for which variables.
@@ -35,15 +37,29 @@ class domain_handler_universe {
         std::fill(std::begin(visited), std::end(visited), 0);
     }
 
+    template <typename distance_t>
     static inline void prepare_distances(vector<distance_t> &distance, const int /*u*/, const distance_t & /*mask_d*/) {
         std::fill(std::begin(distance), std::end(distance), 0);
     }
 
+    template <typename distance_t>
     static inline void prepare_distances(vector<distance_t> &distance, const int /*u*/, const distance_t & /*mask_d*/,
                                          const int start, const int stop) {
         std::fill(std::begin(distance) + start, std::begin(distance) + stop, 0);
     }
 
+    //! as `prepare_visited`, for the qubits in `qubits` alone
+    static inline void prepare_visited(vector<int> &visited, int /*u*/, int /*v*/, const vector<int> &qubits) {
+        for (auto &q : qubits) visited[q] = 0;
+    }
+
+    //! as `prepare_distances`, for the qubits in `qubits` alone
+    template <typename distance_t>
+    static inline void prepare_distances(vector<distance_t> &distance, const int /*u*/, const distance_t & /*mask_d*/,
+                                         const vector<int> &qubits) {
+        for (auto &q : qubits) distance[q] = 0;
+    }
+
     static inline bool accepts_qubit(int /*u*/, int /*q*/) { return 1; }
 };
 
@@ -83,6 +99,7 @@ class domain_handler_masked {
         for (int *stop = vis + visited.size(); vis < stop; ++vis, ++umask, ++vmask) *vis = (*umask) & (*vmask);
     }
 
+    template <typename distance_t>
     inline void prepare_distances(vector<distance_t> &distance, const int u, const distance_t &mask_d) {
         vector<int> &uMask = masks[u];
         int *umask = uMask.data();
@@ -91,6 +108,7 @@ class domain_handler_masked {
         for (; dist < dend; dist++, umask++) *dist = (-(*umask)) * mask_d;
     }
 
+    template <typename distance_t>
     inline void prepare_distances(vector<distance_t> &distance, const int u, const distance_t &mask_d, const int start,
                                   const int stop) {
         vector<int> &uMask = masks[u];
@@ -100,9 +118,142 @@ class domain_handler_masked {
         for (; dist < dend; dist++, umask++) *dist = (-(*umask)) * mask_d;
     }
 
+    //! as `prepare_visited`, for the qubits in `qubits` alone
+    inline void prepare_visited(vector<int> &visited, const int u, const int v, const vector<int> &qubits) {
+        const vector<int> &uMask = masks[u];
+        const vector<int> &vMask = masks[v];
+        for (auto &q : qubits) visited[q] = uMask[q] & vMask[q];
+    }
+
+    //! as `prepare_distances`, for the qubits in `qubits` alone
+    template <typename distance_t>
+    inline void prepare_distances(vector<distance_t> &distance, const int u, const distance_t &mask_d,
+                                  const vector<int> &qubits) {
+        const vector<int> &uMask = masks[u];
+        for (auto &q : qubits) distance[q] = (-uMask[q]) * mask_d;
+    }
+
     inline bool accepts_qubit(const int u, const int q) { return !(masks[u][q]); }
 };
 
+//! this domain handler stores each restriction as a sorted list of disjoint qubit ranges `[start, stop)`.  lattice
+//! targets are labeled so that boxes and unions of unit cells collapse into a handful of ranges, so memory use is
+//! proportional to the number of variables (times the number of ranges) rather than variables times qubits.  the
+//! operations of `domain_handler_masked` are answered by arithmetic on qubit labels: fills over ranges, and a
+//! binary search for `accepts_qubit`
+class domain_handler_ranged {
+    //! the ranges for variable `v` are `bounds[2*i]` through `bounds[2*i+1]` for `offsets[v] <= i < offsets[v+1]`
+    vector<int> offsets;
+    vector<int> bounds;
+
+  public:
+    domain_handler_ranged(optional_parameters &p, int n_v, int n_f, int n_q, int n_r) : offsets(), bounds() {
+#ifndef NDEBUG
+        for (auto &vC : p.restrict_chains)
+            for (auto &q : vC.second) minorminer_assert(0 <= q && q < n_q + n_r);
+#endif
+        vector<int> domain;
+        auto nostrix = std::end(p.restrict_chains);
+        offsets.reserve(n_v + n_f + 1);
+        for (int v = 0; v < n_v + n_f; v++) {
+            offsets.push_back(bounds.size() / 2);
+            auto chain = p.restrict_chains.find(v);
+            if (chain != nostrix) {
+                domain = (*chain).second;
+                collect_ranges(domain, bounds);
+            } else {
+                bounds.push_back(0);
+                bounds.push_back(n_q + n_r);
+            }
+        }
+        offsets.push_back(bounds.size() / 2);
+    }
+    virtual ~domain_handler_ranged() {}
+
+    //! sorts and deduplicates `domain`, and appends its maximal runs of consecutive qubits to `ranges` as
+    //! `start, stop` pairs; returns the number of runs
+    static int collect_ranges(vector<int> &domain, vector<int> &ranges) {
+        std::sort(std::begin(domain), std::end(domain));
+        int runs = 0;
+        for (size_t i = 0; i < domain.size();) {
+            int start = domain[i], stop = start + 1;
+            while (++i < domain.size() && domain[i] <= stop) stop = domain[i] + 1;
+            ranges.push_back(start);
+            ranges.push_back(stop);
+            runs++;
+        }
+        return runs;
+    }
+
+    //! counts the ranges needed to represent `restrict_chains`, so that callers can compare the footprint of this
+    //! handler against `domain_handler_masked` before instantiating either
+    static size_t count_ranges(const map<int, vector<int>> &restrict_chains) {
+        size_t runs = 0;
+        vector<int> domain, ranges;
+        for (auto &vC : restrict_chains) {
+            domain = vC.second;
+            ranges.clear();
+            runs += collect_ranges(domain, ranges);
+        }
+        return runs;
+    }
+
+    inline void prepare_visited(vector<int> &visited, const int u, const int v) {
+        std::fill(std::begin(visited), std::end(visited), -1);
+        const int size = visited.size();
+        // a qubit is open if either domain contains it
+        for (const int w : {u, v}) {
+            const int *a = bounds.data() + 2 * offsets[w], *a_end = bounds.data() + 2 * offsets[w + 1];
+            for (; a < a_end; a += 2) {
+                int start = a[0], stop = min(a[1], size);
+                if (start < stop) std::fill(std::begin(visited) + start, std::begin(visited) + stop, 0);
+            }
+        }
+    }
+
+    template <typename distance_t>
+    inline void prepare_distances(vector<distance_t> &distance, const int u, const distance_t &mask_d) {
+        prepare_distances(distance, u, mask_d, 0, distance.size());
+    }
+
+    template <typename distance_t>
+    inline void prepare_distances(vector<distance_t> &distance, const int u, const distance_t &mask_d, const int start,
+                                  const int stop) {
+        std::fill(std::begin(distance) + start, std::begin(distance) + stop, mask_d);
+        const int *a = bounds.data() + 2 * offsets[u], *a_end = bounds.data() + 2 * offsets[u + 1];
+        for (; a < a_end; a += 2) {
+            int lo = max(a[0], start), hi = min(a[1], stop);
+            if (lo < hi) std::fill(std::begin(distance) + lo, std::begin(distance) + hi, 0);
+        }
+    }
+
+    //! as `prepare_visited`, for the qubits in `qubits` alone; each costs a binary search per domain
+    inline void prepare_visited(vector<int> &visited, const int u, const int v, const vector<int> &qubits) {
+        for (auto &q : qubits) visited[q] = (accepts_qubit(u, q) || accepts_qubit(v, q)) ? 0 : -1;
+    }
+
+    //! as `prepare_distances`, for the qubits in `qubits` alone
+    template <typename distance_t>
+    inline void prepare_distances(vector<distance_t> &distance, const int u, const distance_t &mask_d,
+                                  const vector<int> &qubits) {
+        for (auto &q : qubits) distance[q] = accepts_qubit(u, q) ? 0 : mask_d;
+    }
+
+    inline bool accepts_qubit(const int u, const int q) const {
+        const int *a = bounds.data() + 2 * offsets[u], *a_end = bounds.data() + 2 * offsets[u + 1];
+        // find the last range starting at or before q
+        int lo = 0, hi = (a_end - a) / 2;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (a[2 * mid] <= q)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo > 0 && q < a[2 * lo - 1];
+    }
+};
+
 // Fixed handlers are used to control which variables are allowed to be torn up and replaced.  Currently, there is no
 // option to fix/unfix variables after an embedding problem has been instantiated, but TODO that will be implemented in
 // the future in fixed_handler_list.  Fixed variables are assumed to have chains; reserved qubits are not available for
@@ -207,6 +358,67 @@ class output_handler_error {
     void debug(Args...) const {}
 };
 
+// Weight handlers choose the type of the distances computed by the pathfinders, and the weight given to a qubit for
+// each overlap value `c`.  A path crosses at most `num_q` qubits and a root sums the paths to as many as `max_degree`
+// chains, so the weights are scaled down until those sums can't overflow.  Past a few billion qubit-edges, the 63 bits
+// of `distance_t` leave almost nothing to the penalty, and the wide handler should be used instead.
+//
+// The narrow and wide handlers weigh a qubit by `power`, the overlap value's power of the base chosen by
+// `embedding_problem_base::weight_base`; the lexicographic handler has no base.  Each handler is constructed from the
+// margin of `embedding_problem_base::compute_margin`, and gives the bits left to the weights in `exponent_bits`.
+
+//! This weight handler computes distances in `distance_t`; it is exact, and the fastest.
+class weight_handler_narrow {
+  public:
+    using distance_t = find_embedding::distance_t;
+    static constexpr int exponent_bits = 63;
+
+    explicit weight_handler_narrow(uint64_t /*margin*/) {}
+
+    static inline distance_t weight(int /*c*/, double power) { return static_cast<distance_t>(power); }
+};
+
+//! This weight handler computes distances in `wide_distance_t`, whose exponent leaves room for the full penalty at
+//! any problem size.  Distances are rounded once they exceed 2^53, which only perturbs the order of near ties.
+class weight_handler_wide {
+  public:
+    using distance_t = wide_distance_t;
+    static constexpr int exponent_bits = 1023;
+
+    explicit weight_handler_wide(uint64_t /*margin*/) {}
+
+    static inline distance_t weight(int /*c*/, double power) { return power; }
+};
+
+//! This weight handler packs a pair (overlap, length) into each distance, with the length in the low `length_bits`
+//! bits, so that distances compare lexicographically.  Each qubit adds one to the length and `2^c - 1` to the overlap,
+//! so that a path through any number of empty qubits is shorter than one through a used qubit, and a path through a
+//! qubit used twice is longer than one through two qubits used once.  A sum of distances crosses at most `margin`
+//! qubits, so the length takes just the bits to hold `margin`, and never carries into the overlap.  The overlap takes
+//! the remaining bits, which bounds the overlap values in the same way as the other handlers; but the weights don't
+//! depend on `max_beta` or `round_beta`, and paths of equal overlap are ordered by their exact length.
+class weight_handler_lexicographic {
+  public:
+    using distance_t = find_embedding::distance_t;
+    const int length_bits;
+    const int exponent_bits;
+
+    explicit weight_handler_lexicographic(uint64_t margin)
+            : length_bits(length_bits_for(margin)), exponent_bits(63 - length_bits) {}
+
+    //! the number of bits needed to hold `margin`
+    static int length_bits_for(uint64_t margin) {
+        int bits = 0;
+        while (bits < 63 && (margin >> bits)) bits++;
+        return bits;
+    }
+
+    inline distance_t weight(int c, double /*power*/) const {
+        if (c >= exponent_bits) return numeric_limits<distance_t>::max();
+        return (((distance_t(1) << c) - 1) << length_bits) + 1;
+    }
+};
+
 struct shuffle_first {};
 struct rndswap_first {};
 
@@ -224,21 +436,21 @@ class embedding_problem_base {
     uniform_int_distribution<> rand;
 
     vector<int> var_order_space;
-    vector<int> var_order_visited;
-    vector<int> var_order_shuffle;
 
-    unsigned int exponent_margin;  // probably going to move this weight stuff out to another handler
+    uint64_t exponent_margin;
+    //! the number of bits available to the weights and distances, from the `weight_handler`
+    int exponent_bits;
+
   public:
     //! A mutable reference to the user specified parameters
     optional_parameters &params;
 
     double max_beta, round_beta, bound_beta;
-    distance_t weight_table[64];
 
     int initialized, embedded, desperate, target_chainsize, improved, weight_bound;
 
     embedding_problem_base(optional_parameters &p_, int n_v, int n_f, int n_q, int n_r, vector<vector<int>> &v_n,
-                           vector<vector<int>> &q_n)
+                           vector<vector<int>> &q_n, int e_b)
             : num_v(n_v),
               num_f(n_f),
               num_q(n_q),
@@ -247,9 +459,8 @@ class embedding_problem_base {
               var_nbrs(v_n),
               rand(0, 0xffffffff),
               var_order_space(n_v),
-              var_order_visited(n_v, 0),
-              var_order_shuffle(n_v),
-              exponent_margin(compute_margin()),
+              exponent_margin(compute_margin(v_n, n_q)),
+              exponent_bits(e_b),
               params(p_) {
         if (exponent_margin <= 0) throw MinorMinerException("problem has too few nodes or edges");
         reset_mood();
@@ -259,7 +470,7 @@ class embedding_problem_base {
 
     //! resets some internal, ephemeral, variables to a default state
     void reset_mood() {
-        auto ultramax_weight = 63. - std::log2(exponent_margin);
+        auto ultramax_weight = exponent_budget(exponent_bits, exponent_margin);
 
         if (ultramax_weight < 2) throw MinorMinerException("problem is too large to avoid overflow");
 
@@ -274,43 +485,35 @@ class embedding_problem_base {
         initialized = embedded = desperate = target_chainsize = improved = 0;
     }
 
-  private:
-    //! computes an upper bound on the distances computed during tearout & replace
-    unsigned int compute_margin() {
+    //! computes an upper bound on the distances computed during tearout & replace, in units of the weight of an
+    //! empty qubit: a path crosses at most `num_q` qubits, and a root sums the paths to at most `max_degree` chains
+    static uint64_t compute_margin(const vector<vector<int>> &var_nbrs, int num_q) {
         if (num_q == 0) return 0;
-        unsigned int max_degree =
-                std::max_element(begin(var_nbrs), end(var_nbrs), [](const vector<int> &a, const vector<int> &b) {
-                    return a.size() < b.size();
-                })->size();
+        uint64_t max_degree = 0;
+        for (auto &n : var_nbrs) max_degree = max(max_degree, static_cast<uint64_t>(n.size()));
         if (max_degree == 0)
             return num_q;
         else
             return max_degree * num_q;
     }
 
-  public:
-    //! precomputes a table of weights corresponding to various overlap values `c`,
-    //! for `c` from 0 to `max_weight`, inclusive.
-    void populate_weight_table(int max_weight) {
-        max_weight = min(63, max_weight);
-        double log2base = (max_weight <= 0) ? 1 : ((63. - std::log2(exponent_margin)) / max_weight);
-        double base = min(exp2(log2base), min(max_beta, round_beta));
-        double power = 1;
-        for (int i = 0; i <= max_weight; i++) {
-            weight_table[i] = power;
-            power *= base;
-        }
-        for (int i = max_weight + 1; i < 64; i++) weight_table[i] = max_distance;
+    //! the base-2 logarithm of the largest weight that can be given to a qubit, when distances hold `bits` bits and
+    //! sums of distances must stay within `margin` times that weight; weights never exceed 63 bits, which is plenty
+    static double exponent_budget(int bits, uint64_t margin) {
+        if (margin == 0) return numeric_limits<double>::infinity();
+        return min(63., bits - std::log2(static_cast<double>(margin)));
     }
 
-    //! returns the precomputed weight associated with an overlap value of `c`
-    distance_t weight(unsigned int c) const {
-        if (c >= 64)
-            return max_distance;
-        else
-            return weight_table[c];
+  protected:
+    //! the base of the weights for overlap values from 0 to `max_weight`: the largest that fits the exponent budget
+    //! without overflow, unless `max_beta` or `round_beta` is smaller
+    double weight_base(int max_weight) const {
+        double log2base = (max_weight <= 0) ? 1 : (exponent_budget(exponent_bits, exponent_margin) / max_weight);
+        return min(exp2(log2base), min(max_beta, round_beta));
     }
 
+  public:
+
     //! a vector of neighbors for the variable `u`
     const vector<int> &var_neighbors(int u) const { return var_nbrs[u]; }
 
@@ -363,46 +566,126 @@ class embedding_problem_base {
         dfs_component(q0, qubit_nbrs, component, visited);
     }
 
-    //! compute a variable ordering according to the `order` strategy
+    //! compute a variable ordering according to the `order` strategy.  if `params.order_pool` is positive, the
+    //! ordering is taken from a pool of precomputed orderings instead; see `pooled_order`
     const vector<int> &var_order(VARORDER order = VARORDER_SHUFFLE) {
         if (order == VARORDER_KEEP) {
             minorminer_assert(var_order_space.size() > 0);
             return var_order_space;
         }
-        var_order_space.clear();
-        var_order_shuffle.clear();
-        for (int v = num_v; v--;) var_order_shuffle.push_back(v);
-        shuffle(std::begin(var_order_shuffle), std::end(var_order_shuffle));
+        if (params.order_pool > 0) return pooled_order(order);
+        build_order(order, params.rng, var_order_scratch, var_order_space);
+        return var_order_space;
+    }
+
+    //! Perform a depth first search
+    void dfs_component(int x, const vector<vector<int>> &neighbors, vector<int> &component, vector<int> &visited) {
+        dfs_component(x, neighbors, component, visited, params.rng);
+    }
+
+  private:
+    //! the scratch space used to build a variable ordering; orderings for the pool are built side by side, each in
+    //! its own space
+    struct order_space {
+        vector<int> visited;
+        vector<int> shuffled;
+        //! the number of visited neighbors of each variable discovered by `pfs_component`, and its queue: a bucket
+        //! for each count, holding variables ordered by `shuffled`
+        vector<int> count;
+        vector<min_queue<int>> buckets;
+
+        inline min_queue<int> &bucket(int d) {
+            if (static_cast<int>(buckets.size()) <= d) buckets.resize(d + 1);
+            return buckets[d];
+        }
+    };
+
+    order_space var_order_scratch;
+
+    //! precomputed orderings for each strategy, and the next ordering of each pool to be served
+    vector<vector<vector<int>>> order_pools;
+    vector<unsigned int> order_pool_next;
+
+    //! build an ordering according to `order` into `output`, drawing random numbers from `rng`.  this only
+    //! touches `space`, `output` and `rng`, so several orderings can be built at once
+    template <typename rng_t>
+    void build_order(VARORDER order, rng_t &rng, order_space &space, vector<int> &output) const {
+        output.clear();
+        space.shuffled.clear();
+        for (int v = num_v; v--;) space.shuffled.push_back(v);
+        std::shuffle(std::begin(space.shuffled), std::end(space.shuffled), rng);
         if (order == VARORDER_SHUFFLE) {
-            var_order_shuffle.swap(var_order_space);
+            output = space.shuffled;
         } else {
-            var_order_visited.assign(num_v, 0);
-            var_order_visited.resize(num_v + num_f, 1);
-            for (auto v : var_order_shuffle)
-                if (!var_order_visited[v]) switch (order) {
+            space.visited.assign(num_v, 0);
+            space.visited.resize(num_v + num_f, 1);
+            space.count.assign(num_v + num_f, -1);
+            for (auto v : space.shuffled)
+                if (!space.visited[v]) switch (order) {
                         case VARORDER_DFS:
-                            dfs_component(v, var_nbrs, var_order_space, var_order_visited);
+                            dfs_component(v, var_nbrs, output, space.visited, rng);
                             break;
                         case VARORDER_BFS:
-                            bfs_component(v, var_nbrs, var_order_space, var_order_visited, var_order_shuffle);
+                            bfs_component(v, var_nbrs, output, space.visited, space.shuffled);
                             break;
                         case VARORDER_PFS:
-                            pfs_component<min_queue<int>>(v, var_nbrs, var_order_space, var_order_visited,
-                                                          var_order_shuffle);
+                            pfs_component(v, var_nbrs, output, space);
                             break;
                         case VARORDER_RPFS:
-                            pfs_component<max_queue<int>>(v, var_nbrs, var_order_space, var_order_visited,
-                                                          var_order_shuffle);
+                            rpfs_component(v, var_nbrs, output, space);
                             break;
                         default:
                             throw - 1;
                     }
         }
+    }
+
+    //! serve an ordering from the pool for `order`, filling the pool on first use.  the pool is served in turn, and
+    //! each ordering is perturbed by a few random transpositions of neighboring variables as it is served, so that
+    //! passes keep seeing fresh orderings without paying to build them
+    const vector<int> &pooled_order(VARORDER order) {
+        if (order_pools.empty()) {
+            order_pools.resize(VARORDER_KEEP);
+            order_pool_next.assign(VARORDER_KEEP, 0);
+        }
+        auto &pool = order_pools[order];
+        if (pool.empty()) fill_order_pool(order, pool);
+        auto &ordering = pool[order_pool_next[order]++ % pool.size()];
+        if (num_v > 1) {
+            for (int i = max(1, num_v / 16); i--;) {
+                int j = randint(0, num_v - 2);
+                std::swap(ordering[j], ordering[j + 1]);
+            }
+        }
+        var_order_space = ordering;
         return var_order_space;
     }
 
-    //! Perform a depth first search
-    void dfs_component(int x, const vector<vector<int>> &neighbors, vector<int> &component, vector<int> &visited) {
+    //! build `params.order_pool` orderings according to `order`, split between up to `params.threads` threads.
+    //! each ordering draws from its own stream split off `params.rng`, so the pool doesn't depend on the number of
+    //! threads
+    void fill_order_pool(VARORDER order, vector<vector<int>> &pool) {
+        const int size = params.order_pool;
+        vector<RANDOM> streams;
+        for (int i = 0; i < size; i++) streams.push_back(params.rng.split());
+        pool.assign(size, vector<int>());
+
+        const int num_workers = max(1, min(size, params.threads));
+        vector<order_space> spaces(num_workers);
+        std::atomic<int> next_job(0);
+        auto work = [&, this](const int t) {
+            for (int i; (i = next_job++) < size;) build_order(order, streams[i], spaces[t], pool[i]);
+        };
+        vector<std::future<void>> workers;
+        for (int t = 1; t < num_workers; t++) workers.push_back(std::async(std::launch::async, work, t));
+        work(0);
+        for (auto &w : workers) w.wait();
+    }
+
+    //! Perform a depth first search, shuffling the neighbors of each variable with `rng`
+    template <typename rng_t>
+    void dfs_component(int x, const vector<vector<int>> &neighbors, vector<int> &component, vector<int> &visited,
+                       rng_t &rng) const {
         size_t front = component.size();
         component.push_back(x);
         visited[x] = 1;
@@ -415,29 +698,69 @@ class embedding_problem_base {
                     component.push_back(y);
                 }
             }
-            if (lastback != component.size()) shuffle(std::begin(component) + lastback, std::end(component));
+            if (lastback != component.size()) std::shuffle(std::begin(component) + lastback, std::end(component), rng);
         }
     }
 
-  private:
-    //! Perform a priority first search (priority = #of visited neighbors)
-    template <typename queue_t>
-    void pfs_component(int x, const vector<vector<int>> &neighbors, vector<int> &component, vector<int> &visited,
-                       vector<int> shuffled) {
-        queue_t pq;
+    //! Perform a priority first search (priority = #of visited neighbors, ties broken by least `shuffled`).  the
+    //! counts are kept up to date as variables are visited, and a variable is queued again in the next bucket up each
+    //! time its count grows; entries left behind in lower buckets are skipped.  so each edge is handled a constant
+    //! number of times, rather than each neighbor's neighbors being counted over again
+    void pfs_component(int x, const vector<vector<int>> &neighbors, vector<int> &component, order_space &space) const {
+        auto &visited = space.visited;
+        auto &shuffled = space.shuffled;
+        auto &count = space.count;
+        count[x] = 0;
+        int top = 0;
+        space.bucket(0).emplace(x, shuffled[x], 0);
+        while (top >= 0) {
+            auto &b = space.buckets[top];
+            if (b.empty()) {
+                top--;
+                continue;
+            }
+            x = b.top().node;
+            b.pop();
+            if (visited[x] || count[x] != top) continue;
+            visited[x] = 1;
+            component.push_back(x);
+
+            for (auto y : neighbors[x]) {
+                if (visited[y]) continue;
+                if (count[y] < 0) {
+                    // first discovery: count every visited neighbor, including fixed variables
+                    int d = 0;
+                    for (auto w : neighbors[y]) d += visited[w];
+                    count[y] = d;
+                } else {
+                    count[y]++;
+                }
+                space.bucket(count[y]).emplace(y, shuffled[y], 0);
+                top = max(top, count[y]);
+            }
+        }
+    }
+
+    //! Perform a reverse priority first search, which takes the variable with the fewest visited neighbors at the time
+    //! it was first discovered (ties broken by greatest `shuffled`)
+    void rpfs_component(int x, const vector<vector<int>> &neighbors, vector<int> &component, order_space &space) const {
+        auto &visited = space.visited;
+        auto &shuffled = space.shuffled;
+        auto &count = space.count;
+        max_queue<int> pq;
+        count[x] = 0;
         pq.emplace(x, shuffled[x], 0);
         while (!pq.empty()) {
-            auto z = pq.top();
+            x = pq.top().node;
             pq.pop();
-            x = z.node;
-            if (visited[x]) continue;
             visited[x] = 1;
             component.push_back(x);
 
             for (auto y : neighbors[x]) {
-                if (!visited[y]) {
+                if (!visited[y] && count[y] < 0) {
                     int d = 0;
                     for (auto w : neighbors[y]) d -= visited[w];
+                    count[y] = -d;
                     pq.emplace(y, shuffled[y], d);
                 }
             }
@@ -446,7 +769,7 @@ class embedding_problem_base {
 
     //! Perform a breadth first search, shuffling level sets
     void bfs_component(int x, const vector<vector<int>> &neighbors, vector<int> &component, vector<int> &visited,
-                       vector<int> &shuffled) {
+                       vector<int> &shuffled) const {
         min_queue<int> pq;
         pq.emplace(x, shuffled[x], 0);
         visited[x] = 1;
@@ -468,25 +791,60 @@ class embedding_problem_base {
 };
 
 //! A template to construct a complete embedding problem by combining
-//! `embedding_problem_base` with fixed/domain handlers.
-template <class fixed_handler, class domain_handler, class output_handler>
-class embedding_problem : public embedding_problem_base,
+//! `embedding_problem_base` with fixed/domain/output/weight handlers.
+template <class fixed_handler, class domain_handler, class output_handler, class weight_handler = weight_handler_narrow>
+class embedding_problem : public weight_handler,
+                          public embedding_problem_base,
                           public fixed_handler,
                           public domain_handler,
                           public output_handler {
   private:
+    using wh_t = weight_handler;
     using ep_t = embedding_problem_base;
     using fh_t = fixed_handler;
     using dh_t = domain_handler;
     using oh_t = output_handler;
 
+  public:
+    using distance_t = typename weight_handler::distance_t;
+
+  private:
+    static constexpr distance_t max_distance = numeric_limits<distance_t>::max();
+    distance_t weight_table[64];
+
   public:
     embedding_problem(optional_parameters &p, int n_v, int n_f, int n_q, int n_r, vector<vector<int>> &v_n,
                       vector<vector<int>> &q_n)
-            : embedding_problem_base(p, n_v, n_f, n_q, n_r, v_n, q_n),
+            : weight_handler(compute_margin(v_n, n_q)),
+              embedding_problem_base(p, n_v, n_f, n_q, n_r, v_n, q_n, weight_handler::exponent_bits),
               fixed_handler(p, n_v, n_f, n_q, n_r),
               domain_handler(p, n_v, n_f, n_q, n_r),
               output_handler(p) {}
     virtual ~embedding_problem() {}
+
+    //! precomputes a table of weights corresponding to various overlap values `c`,
+    //! for `c` from 0 to `max_weight`, inclusive.
+    void populate_weight_table(int max_weight) {
+        max_weight = min(63, max_weight);
+        double base = weight_base(max_weight);
+        double power = 1;
+        for (int i = 0; i <= max_weight; i++) {
+            weight_table[i] = weight_handler::weight(i, power);
+            power *= base;
+        }
+        for (int i = max_weight + 1; i < 64; i++) weight_table[i] = max_distance;
+    }
+
+    //! returns the precomputed weight associated with an overlap value of `c`
+    distance_t weight(unsigned int c) const {
+        if (c >= 64)
+            return max_distance;
+        else
+            return weight_table[c];
+    }
 };
+
+template <class fixed_handler, class domain_handler, class output_handler, class weight_handler>
+constexpr typename weight_handler::distance_t
+        embedding_problem<fixed_handler, domain_handler, output_handler, weight_handler>::max_distance;
 }
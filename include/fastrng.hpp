@@ -23,7 +23,9 @@ class fastrng {
   public:
     typedef uint64_t result_type;
 
-    fastrng() {}
+    //! a generator with a fixed, nonzero state, for callers that never seed it -- an all-zero state would only
+    //! ever produce zeros, and pass them on through `split`
+    fastrng() : fastrng(UINT64_C(0)) {}
 
     fastrng(uint64_t x) {
         S0 = splitmix64(x);
@@ -41,7 +43,9 @@ class fastrng {
     inline void seed(uint64_t x) {
         S0 = splitmix64(x);
         S1 = splitmix64(x);
-        discard(1024);
+        // equivalent to discard(1024)
+        static const uint64_t skip[2] = {UINT64_C(0x69eea157ecbba59c), UINT64_C(0xf51950df6eec6a5a)};
+        advance(skip);
     }
 
     uint64_t operator()() {
@@ -53,16 +57,84 @@ class fastrng {
         return S1 + y;
     }
 
-    void discard(int n) {
-        while (n-- > 0) {
-            uint64_t x = S0;
-            uint64_t const y = S1;
-            S0 = y;
-            x ^= x << 23;                        // a
-            S1 = x ^ y ^ (x >> 17) ^ (y >> 26);  // b, c
+    //! skip the next `n` outputs, in time logarithmic in `n`
+    void discard(unsigned long long n) {
+        if (n < 256) {
+            while (n-- > 0) step();
+            return;
         }
+        // x^n modulo the characteristic polynomial, by squaring and multiplying
+        uint64_t poly[2] = {1, 0}, base[2] = {2, 0};
+        for (; n; n >>= 1) {
+            if (n & 1) mulmod(poly, base);
+            mulmod(base, base);
+        }
+        advance(poly);
+    }
+
+    //! skip the next 2^64 outputs
+    void jump() {
+        static const uint64_t skip[2] = {UINT64_C(0x8c405782bca686ad), UINT64_C(0xc44f35946fef49c6)};
+        advance(skip);
+    }
+
+    //! returns a generator for the next 2^64 outputs of this one, and jumps this one past them.  the streams split
+    //! off one after another never overlap, so long as none of them draws 2^64 numbers
+    fastrng split() {
+        fastrng child(*this);
+        jump();
+        return child;
     }
 
     static constexpr uint64_t min() { return std::numeric_limits<uint64_t>::min(); }
     static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+
+  private:
+    inline void step() {
+        uint64_t x = S0;
+        uint64_t const y = S1;
+        S0 = y;
+        x ^= x << 23;                        // a
+        S1 = x ^ y ^ (x >> 17) ^ (y >> 26);  // b, c
+    }
+
+    //! the state update is linear over GF(2); a polynomial `p` in it, with the coefficient of x^i in bit i, moves
+    //! the state to p(T) applied to the state.  x^n mod the characteristic polynomial of T skips n steps
+    void advance(const uint64_t (&poly)[2]) {
+        uint64_t s0 = 0, s1 = 0;
+        for (int w = 0; w < 2; w++) {
+            for (int b = 0; b < 64; b++) {
+                if (poly[w] >> b & 1) {
+                    s0 ^= S0;
+                    s1 ^= S1;
+                }
+                step();
+            }
+        }
+        S0 = s0;
+        S1 = s1;
+    }
+
+    //! a = a * b modulo the characteristic polynomial of the state update, which is x^128 + `charpoly`
+    static void mulmod(uint64_t (&a)[2], const uint64_t (&b)[2]) {
+        static const uint64_t charpoly[2] = {UINT64_C(0xbd82fd40e01730f9), UINT64_C(0x01f9f801f6fd0098)};
+        uint64_t r[2] = {0, 0}, c[2] = {a[0], a[1]};
+        for (int w = 0; w < 2; w++) {
+            for (int bit = 0; bit < 64; bit++) {
+                if (b[w] >> bit & 1) {
+                    r[0] ^= c[0];
+                    r[1] ^= c[1];
+                }
+                uint64_t carry = c[1] >> 63;
+                c[1] = (c[1] << 1) | (c[0] >> 63);
+                c[0] <<= 1;
+                if (carry) {
+                    c[0] ^= charpoly[0];
+                    c[1] ^= charpoly[1];
+                }
+            }
+        }
+        a[0] = r[0];
+        a[1] = r[1];
+    }
 };
@@ -115,15 +115,72 @@ class parameter_processor {
     }
 };
 
-template <bool parallel, bool fixed, bool restricted, bool verbose>
+//! selects the domain handler: none when there are no restrictions, otherwise
+//! either dense per-variable masks or sorted qubit ranges (see embedding_problem.hpp)
+enum RESTRICTION { RESTRICT_NONE, RESTRICT_MASKED, RESTRICT_RANGED };
+
+//! selects the weight handler: exponential weights in integer or floating point distances, or (overlap, length)
+//! pairs packed into integers (see embedding_problem.hpp)
+enum WEIGHTS { WEIGHTS_NARROW, WEIGHTS_WIDE, WEIGHTS_LEXICOGRAPHIC };
+
+//! A conservative estimate of the peak memory, in bytes, used to embed a source graph with `num_vars` variables (of
+//! which `num_fixed` have fixed chains) into a target with `num_qubits` qubits (of which `num_reserved` are held by
+//! fixed chains), where `var_degree` and `qubit_degree` are the total degrees (twice the edge counts) of the two
+//! graphs.  Restrictions, which hold `restricted_qubits` qubits in all, are stored as masks over the qubits for
+//! `restricted_vars` variables, or as `num_ranges` ranges of qubits, according to `restricted`.  This can be called
+//! before anything is allocated; the pathfinder itself holds tables of one distance and three ints per variable per
+//! qubit, which dominate for large problems.
+inline size_t estimate_memory(size_t num_vars, size_t num_fixed, size_t num_qubits, size_t num_reserved,
+                              size_t var_degree, size_t qubit_degree, RESTRICTION restricted, size_t restricted_vars,
+                              size_t restricted_qubits, size_t num_ranges, int threads, int order_pool) {
+    const size_t num_free = num_vars - num_fixed, num_q = num_qubits + num_reserved, num_free_q = num_qubits;
+    const size_t word = sizeof(int), dist = sizeof(distance_t), ptr = sizeof(void *);
+    // a chain qubit or link is a hash map node drawn from a node_pool, plus a bucket; the chains of an embedding
+    // may overlap, so we allow for each qubit to be held twice
+    const size_t chain_node = 2 * node_pool::unit + ptr;
+    const size_t embedding = num_q * sizeof(fill_t) + num_vars * sizeof(chain) + (2 * num_q + var_degree) * chain_node;
+
+    // the input graphs, their neighbor lists, and the neighbor lists of the embedding problem and its components
+    size_t bytes = 3 * (var_degree + qubit_degree) * word + 3 * (num_vars + num_q) * sizeof(vector<int>);
+    // parents and distances over every qubit, visited lists and tie-breaking permutations over the free ones
+    bytes += num_vars * (num_q * (word + dist) + 2 * num_free_q * word);
+    // best, last, current and initial embeddings, each with a scratch chain of five ints per qubit
+    bytes += 4 * (embedding + 5 * num_q * word);
+    // weights, distance totals, probe distances and stamps, and the eight landmark hop counts over the qubits
+    bytes += num_q * (3 * dist + 10 * word);
+    if (threads > 1) bytes += num_q * (dist + sizeof(std::pair<int, distance_t>));
+    if (order_pool > 0) bytes += 3 * static_cast<size_t>(order_pool) * num_free * word;
+    // the restrictions are copied twice on their way to the domain handler
+    if (restricted != RESTRICT_NONE) bytes += 3 * restricted_qubits * word;
+    switch (restricted) {
+        case RESTRICT_MASKED:
+            bytes += restricted_vars * num_q * word;
+            break;
+        case RESTRICT_RANGED:
+            bytes += (2 * num_ranges + 2 * num_vars) * word;
+            break;
+        case RESTRICT_NONE:
+            break;
+    }
+    return bytes;
+}
+
+template <bool parallel, bool fixed, RESTRICTION restricted, bool verbose, WEIGHTS weights>
 class pathfinder_type {
   public:
     typedef typename std::conditional<fixed, fixed_handler_hival, fixed_handler_none>::type fixed_handler_t;
-    typedef typename std::conditional<restricted, domain_handler_masked, domain_handler_universe>::type
-            domain_handler_t;
+    typedef typename std::conditional<
+            restricted == RESTRICT_NONE, domain_handler_universe,
+            typename std::conditional<restricted == RESTRICT_RANGED, domain_handler_ranged,
+                                      domain_handler_masked>::type>::type domain_handler_t;
     typedef typename std::conditional<verbose, output_handler_full, output_handler_error>::type output_handler_t;
-    typedef embedding_problem<fixed_handler_t, domain_handler_t, output_handler_t> embedding_problem_t;
-    typedef typename std::conditional<parallel, pathfinder_parallel<embedding_problem_t>,
+    typedef typename std::conditional<
+            weights == WEIGHTS_NARROW, weight_handler_narrow,
+            typename std::conditional<weights == WEIGHTS_WIDE, weight_handler_wide,
+                                      weight_handler_lexicographic>::type>::type weight_handler_t;
+    typedef embedding_problem<fixed_handler_t, domain_handler_t, output_handler_t, weight_handler_t>
+            embedding_problem_t;
+    typedef typename std::conditional<parallel, pathfinder_hybrid<embedding_problem_t>,
                                       pathfinder_serial<embedding_problem_t>>::type pathfinder_t;
 };
 
@@ -159,27 +216,111 @@ class pathfinder_wrapper {
     }
 
   private:
-    template <bool parallel, bool fixed, bool restricted, bool verbose, typename... Args>
+    //! below this many bits for the penalty, distances are computed with the wide weight handler
+    static constexpr double wide_threshold = 32;
+
+    template <bool parallel, bool fixed, RESTRICTION restricted, bool verbose, WEIGHTS weights, typename... Args>
     inline std::unique_ptr<pathfinder_public_interface> _pf_parse4(Args &&... args) {
         return std::unique_ptr<pathfinder_public_interface>(static_cast<pathfinder_public_interface *>(
-                new (typename pathfinder_type<parallel, fixed, restricted, verbose>::pathfinder_t)(
+                new (typename pathfinder_type<parallel, fixed, restricted, verbose, weights>::pathfinder_t)(
                         std::forward<Args>(args)...)));
     }
 
-    template <bool parallel, bool fixed, bool restricted, typename... Args>
+    template <bool parallel, bool fixed, RESTRICTION restricted, typename... Args>
     inline std::unique_ptr<pathfinder_public_interface> _pf_parse3(Args &&... args) {
         if (pp.params.verbose > 0)
-            return _pf_parse4<parallel, fixed, restricted, true>(std::forward<Args>(args)...);
+            return _pf_parse4<parallel, fixed, restricted, true, WEIGHTS_NARROW>(std::forward<Args>(args)...);
         else
-            return _pf_parse4<parallel, fixed, restricted, false>(std::forward<Args>(args)...);
+            return _pf_parse4<parallel, fixed, restricted, false, WEIGHTS_NARROW>(std::forward<Args>(args)...);
     }
 
     template <bool parallel, bool fixed, typename... Args>
     inline std::unique_ptr<pathfinder_public_interface> _pf_parse2(Args &&... args) {
-        if (pp.params.restrict_chains.size())
-            return _pf_parse3<parallel, fixed, true>(std::forward<Args>(args)...);
-        else
-            return _pf_parse3<parallel, fixed, false>(std::forward<Args>(args)...);
+        switch (choose_domains()) {
+            case RESTRICT_NONE:
+                return _pf_parse3<parallel, fixed, RESTRICT_NONE>(std::forward<Args>(args)...);
+            case RESTRICT_RANGED:
+                return _pf_parse3<parallel, fixed, RESTRICT_RANGED>(std::forward<Args>(args)...);
+            default:
+                return _pf_parse3<parallel, fixed, RESTRICT_MASKED>(std::forward<Args>(args)...);
+        }
+    }
+
+    //! the number of qubit ranges needed to hold the restrictions, counting one for each unrestricted variable
+    size_t num_ranges() const {
+        return domain_handler_ranged::count_ranges(pp.params.restrict_chains) + pp.num_vars -
+               pp.params.restrict_chains.size();
+    }
+
+    //! the masks take one int per variable per qubit, and each range takes two ints; we only pay for the binary
+    //! searches of the ranged handler when it is at least eight times smaller than the masks
+    bool prefer_ranged_domains() const {
+        size_t num_v = pp.num_vars;
+        size_t num_q = pp.problem_qubits;
+        return 16 * num_ranges() < num_v * num_q;
+    }
+
+    size_t memory_estimate(RESTRICTION restricted) const {
+        size_t var_degree = 0, qubit_degree = 0, restricted_qubits = 0;
+        for (auto &n : pp.var_nbrs) var_degree += n.size();
+        for (auto &n : pp.qubit_nbrs) qubit_degree += n.size();
+        for (auto &vC : pp.params.restrict_chains) restricted_qubits += vC.second.size();
+        return estimate_memory(pp.num_vars, pp.num_fixed, pp.problem_qubits - pp.problem_reserved, pp.problem_reserved,
+                               var_degree, qubit_degree, restricted, pp.params.restrict_chains.size(),
+                               restricted_qubits, num_ranges(), pp.params.threads, pp.params.order_pool);
+    }
+
+    //! pick the domain handler, falling back to the (slower but smaller) ranged handler when the masks would exceed
+    //! the memory budget; throws MemoryBudgetException if the problem can't be fit in the budget either way
+    RESTRICTION choose_domains() {
+        RESTRICTION restricted = RESTRICT_NONE;
+        if (pp.params.restrict_chains.size() != 0)
+            restricted = prefer_ranged_domains() ? RESTRICT_RANGED : RESTRICT_MASKED;
+        size_t budget = pp.params.memory_budget;
+        if (budget == 0) return restricted;
+        size_t estimate = memory_estimate(restricted);
+        if (estimate > budget && restricted == RESTRICT_MASKED) {
+            size_t ranged = memory_estimate(RESTRICT_RANGED);
+            if (ranged <= budget) {
+                pp.params.major_info("restricting chains by qubit ranges to fit the memory budget\n");
+                return RESTRICT_RANGED;
+            }
+            estimate = std::min(estimate, ranged);
+        }
+        check_budget(estimate);
+        return restricted;
+    }
+
+    //! throws MemoryBudgetException if `estimate` bytes are over the memory budget
+    void check_budget(size_t estimate) const {
+        size_t budget = pp.params.memory_budget;
+        if (budget != 0 && estimate > budget)
+            throw MemoryBudgetException("an estimated " + std::to_string(estimate) +
+                                        " bytes are needed for this problem, over the memory_budget of " +
+                                        std::to_string(budget));
+    }
+
+    //! true if the penalties of this problem don't fit in the integer distances of the narrow weight handler
+    bool needs_wide_weights() const {
+        uint64_t margin = embedding_problem_base::compute_margin(pp.var_nbrs, pp.problem_qubits - pp.problem_reserved);
+        return embedding_problem_base::exponent_budget(weight_handler_narrow::exponent_bits, margin) < wide_threshold;
+    }
+
+    //! true if the lexicographic weights leave room for an overlap of at least 2 beside the lengths of this problem
+    bool lexicographic_weights_fit() const {
+        uint64_t margin = embedding_problem_base::compute_margin(pp.var_nbrs, pp.problem_qubits - pp.problem_reserved);
+        return embedding_problem_base::exponent_budget(weight_handler_lexicographic(margin).exponent_bits, margin) >= 2;
+    }
+
+    //! The wide weights are only needed for very large problems, and the lexicographic ones on request, so each gets a
+    //! single pathfinder rather than one for each combination of the other handlers: it runs any number of threads,
+    //! takes fixed chains and restrictions (as qubit ranges), and checks the verbosity of each message at runtime.
+    template <WEIGHTS weights, typename... Args>
+    inline std::unique_ptr<pathfinder_public_interface> _pf_parse_general(Args &&... args) {
+        // with one thread, the hybrid pathfinder runs every search inline, as the serial one does
+        pp.params.threads = std::max(1, pp.params.threads);
+        if (pp.params.memory_budget != 0) check_budget(memory_estimate(RESTRICT_RANGED));
+        return _pf_parse4<true, true, RESTRICT_RANGED, true, weights>(std::forward<Args>(args)...);
     }
 
     template <bool parallel, typename... Args>
@@ -192,6 +333,16 @@ class pathfinder_wrapper {
 
     template <typename... Args>
     inline std::unique_ptr<pathfinder_public_interface> _pf_parse(Args &&... args) {
+        if (pp.params.lexicographic_weights) {
+            if (lexicographic_weights_fit())
+                return _pf_parse_general<WEIGHTS_LEXICOGRAPHIC>(std::forward<Args>(args)...);
+            pp.params.major_info("problem is too large for lexicographic weights; using floating point weights\n");
+            return _pf_parse_general<WEIGHTS_WIDE>(std::forward<Args>(args)...);
+        }
+        if (needs_wide_weights()) {
+            pp.params.major_info("problem is large enough to compute distances in floating point\n");
+            return _pf_parse_general<WEIGHTS_WIDE>(std::forward<Args>(args)...);
+        }
         if (pp.params.threads > 1)
             return _pf_parse1<true>(std::forward<Args>(args)...);
         else
@@ -204,17 +355,27 @@ class pathfinder_wrapper {
 //! This method primarily dispatches the proper implementation of the algorithm
 //! where some parameters/behaviours have been fixed at compile time.
 //!
-//! In terms of dispatch, there are three dynamically-selected classes which
-//! are combined, each according to a specific optional parameter.
+//! In terms of dispatch, there are four dynamically-selected classes which
+//! are combined, each according to a specific optional parameter or the
+//! size of the problem.
 //!   * a domain_handler, described in embedding_problem.hpp, manages
 //!     constraints of the form "variable a's chain must be a subset of..."
+//!     restrictions are stored as masks or as qubit ranges, whichever is
+//!     considerably smaller
 //!   * a fixed_handler, described in embedding_problem.hpp, manages
 //!     contstraints of the form "variable a's chain must be exactly..."
 //!   * a pathfinder, described in pathfinder.hpp, which come in two flavors,
-//!     serial and parallel
+//!     serial and hybrid; the hybrid pathfinder decides for each chain
+//!     placement whether threads are worth launching
+//!   * a weight_handler, described in embedding_problem.hpp, sets the type of
+//!     the distances; floating point is used when the problem is so large
+//!     that integer distances would leave little room for the penalty, and
+//!     (overlap, length) pairs when lexicographic_weights is set, unless the
+//!     lengths leave too little room for the overlap, when floating point is
+//!     used again
 //! The optional parameters themselves can be found in util.hpp.  Respectively,
-//! the controlling options for the above are restrict_chains, fixed_chains,
-//! and threads.
+//! the controlling options for the first three are restrict_chains,
+//! fixed_chains, and threads.
 int findEmbedding(graph::input_graph &var_g, graph::input_graph &qubit_g, optional_parameters &params,
                   vector<vector<int>> &chains) {
     pathfinder_wrapper pf(var_g, qubit_g, params);
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "graph.hpp"
+#include "util.hpp"
+
+//! Generators for the graphs used in tests and benchmarks, so that C++ code can build large workloads without the
+//! help of networkx and dwave_networkx.  Hardware graphs are labeled as dwave_networkx labels them by default (by the
+//! linear index of each qubit's coordinates), so the same embedding problems can be posed from Python and C++.
+//! Random graphs are drawn from a `fastrng` seeded by the caller, and are the same on every platform.
+namespace graph {
+
+namespace detail {
+//! an integer in [0, n); the bias is negligible for the sizes of graph we build
+inline int below(fastrng &rng, int n) { return static_cast<int>(rng() % static_cast<uint64_t>(n)); }
+
+//! a uniform double in [0, 1)
+inline double unit(fastrng &rng) { return (rng() >> 11) * (1.0 / (UINT64_C(1) << 53)); }
+
+inline void check(bool ok, const char *msg) {
+    if (!ok) throw find_embedding::MinorMinerException(msg);
+}
+}
+
+//! The Chimera graph C(m, n, t): an m by n grid of complete bipartite cells K(t, t).  The qubit with coordinates
+//! (i, j, u, k) -- row, column, orientation and index within the shore -- is labeled ((i*n + j)*2 + u)*t + k.
+inline input_graph chimera(int m, int n = -1, int t = 4) {
+    if (n < 0) n = m;
+    detail::check(m > 0 && n > 0 && t > 0, "chimera: dimensions must be positive");
+    auto label = [n, t](int i, int j, int u, int k) { return ((i * n + j) * 2 + u) * t + k; };
+    input_graph g(m * n * 2 * t, {}, {});
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            for (int k = 0; k < t; k++) {
+                for (int h = 0; h < t; h++) g.push_back(label(i, j, 0, k), label(i, j, 1, h));
+                if (i + 1 < m) g.push_back(label(i, j, 0, k), label(i + 1, j, 0, k));
+                if (j + 1 < n) g.push_back(label(i, j, 1, k), label(i, j + 1, 1, k));
+            }
+        }
+    }
+    return g;
+}
+
+//! The Pegasus graph P(m), with the standard offsets.  The qubit with coordinates (u, w, k, z) is labeled
+//! ((u*m + w)*12 + k)*(m-1) + z.  Qubit (u, w, k, z) lies on line 12*w + k, perpendicular to the lines of qubits with
+//! orientation 1 - u, and spans 12 of those lines, starting at 12*z + offset[u][k]; it is coupled to every qubit
+//! it crosses, to the next qubit along its line, and to the qubit on the adjacent line k^1 with the same w and z.
+//! When `fabric_only` is set (as in dwave_networkx), the qubits on the outermost lines, which cross nothing, are
+//! left out.  They keep their labels, which are then isolated nodes of the graph.
+inline input_graph pegasus(int m, bool fabric_only = true) {
+    detail::check(m > 1, "pegasus: m must be at least 2");
+    static const int offset[2][12] = {{2, 2, 2, 2, 10, 10, 10, 10, 6, 6, 6, 6}, {6, 6, 6, 6, 2, 2, 2, 2, 10, 10, 10, 10}};
+    auto label = [m](int u, int w, int k, int z) { return ((u * m + w) * 12 + k) * (m - 1) + z; };
+    // the lines of orientation u are crossed by the qubits of orientation 1-u from position lo[u] up to hi[u]
+    int lo[2], hi[2];
+    for (int u = 0; u < 2; u++) {
+        lo[u] = *std::min_element(offset[1 - u], offset[1 - u] + 12);
+        hi[u] = 12 * (m - 2) + *std::max_element(offset[1 - u], offset[1 - u] + 12) + 12;
+    }
+    auto in_fabric = [&](int u, int w, int k) { return !fabric_only || (lo[u] <= 12 * w + k && 12 * w + k < hi[u]); };
+
+    input_graph g(24 * m * (m - 1), {}, {});
+    for (int u = 0; u < 2; u++) {
+        for (int w = 0; w < m; w++) {
+            for (int k = 0; k < 12; k++) {
+                if (!in_fabric(u, w, k)) continue;
+                for (int z = 0; z < m - 1; z++) {
+                    if (z + 1 < m - 1) g.push_back(label(u, w, k, z), label(u, w, k, z + 1));
+                    if (!(k & 1) && in_fabric(u, w, k + 1)) g.push_back(label(u, w, k, z), label(u, w, k + 1, z));
+                }
+            }
+        }
+    }
+    // each vertical qubit crosses 12 horizontal lines; on each, exactly one segment covers it (if any exists)
+    for (int w = 0; w < m; w++) {
+        for (int k = 0; k < 12; k++) {
+            if (!in_fabric(0, w, k)) continue;
+            for (int z = 0; z < m - 1; z++) {
+                for (int kk = 0; kk < 12; kk++) {
+                    int ww = z + (kk < offset[0][k]);
+                    int zz = w - (k < offset[1][kk]);
+                    if (zz < 0 || zz >= m - 1 || !in_fabric(1, ww, kk)) continue;
+                    g.push_back(label(0, w, k, z), label(1, ww, kk, zz));
+                }
+            }
+        }
+    }
+    return g;
+}
+
+//! The Zephyr graph Z(m, t).  The qubit with coordinates (u, w, k, j, z) is labeled
+//! (((u*(2m+1) + w)*t + k)*2 + j)*m + z.  Qubit (u, w, k, j, z) lies in block w of its orientation and spans the
+//! two perpendicular blocks 2z + j and 2z + j + 1; it is coupled to every qubit of the other orientation which it
+//! crosses, to the next qubit along its line, and to the two qubits with the other value of j which overlap it.
+inline input_graph zephyr(int m, int t = 4) {
+    detail::check(m > 0 && t > 0, "zephyr: dimensions must be positive");
+    const int M = 2 * m + 1;
+    auto label = [m, t, M](int u, int w, int k, int j, int z) { return (((u * M + w) * t + k) * 2 + j) * m + z; };
+    input_graph g(4 * t * m * M, {}, {});
+    for (int u = 0; u < 2; u++) {
+        for (int w = 0; w < M; w++) {
+            for (int k = 0; k < t; k++) {
+                for (int z = 0; z < m; z++) {
+                    for (int j = 0; j < 2; j++)
+                        if (z + 1 < m) g.push_back(label(u, w, k, j, z), label(u, w, k, j, z + 1));
+                    g.push_back(label(u, w, k, 0, z), label(u, w, k, 1, z));
+                    if (z > 0) g.push_back(label(u, w, k, 0, z), label(u, w, k, 1, z - 1));
+                }
+            }
+        }
+    }
+    // the vertical qubit (w, j, z) crosses the horizontal qubits in blocks 2z + j and 2z + j + 1 which span block w;
+    // for each value of jj there is one, with 2zz + jj equal to w or w - 1
+    for (int w = 0; w < M; w++) {
+        for (int j = 0; j < 2; j++) {
+            for (int z = 0; z < m; z++) {
+                for (int ww = 2 * z + j; ww < 2 * z + j + 2; ww++) {
+                    for (int jj = 0; jj < 2 && jj <= w; jj++) {
+                        int zz = (w - jj) / 2;
+                        if (zz >= m) continue;
+                        for (int k = 0; k < t; k++)
+                            for (int kk = 0; kk < t; kk++) g.push_back(label(0, w, k, j, z), label(1, ww, kk, jj, zz));
+                    }
+                }
+            }
+        }
+    }
+    return g;
+}
+
+//! A copy of `g` with random defects: each node is removed (with all of its edges) with probability `node_rate`,
+//! and each remaining edge is removed with probability `edge_rate`.  Nodes keep their labels.
+inline input_graph random_defects(const input_graph &g, double node_rate, double edge_rate, uint64_t seed) {
+    fastrng rng(seed);
+    std::vector<char> dead(g.num_nodes(), 0);
+    for (auto &d : dead) d = detail::unit(rng) < node_rate;
+    input_graph h(g.num_nodes(), {}, {});
+    for (int i = 0; i < g.num_edges(); i++) {
+        int a = g.a(i), b = g.b(i);
+        if (dead[a] || dead[b] || detail::unit(rng) < edge_rate) continue;
+        h.push_back(a, b);
+    }
+    return h;
+}
+
+//! The complete graph on n nodes
+inline input_graph clique(int n) {
+    detail::check(n >= 0, "clique: n must be nonnegative");
+    input_graph g(n, {}, {});
+    for (int a = 0; a < n; a++)
+        for (int b = a + 1; b < n; b++) g.push_back(a, b);
+    return g;
+}
+
+//! The rows by cols grid graph; the node in row r and column c is labeled r*cols + c
+inline input_graph grid(int rows, int cols) {
+    detail::check(rows >= 0 && cols >= 0, "grid: dimensions must be nonnegative");
+    input_graph g(rows * cols, {}, {});
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            if (r + 1 < rows) g.push_back(r * cols + c, (r + 1) * cols + c);
+            if (c + 1 < cols) g.push_back(r * cols + c, r * cols + c + 1);
+        }
+    }
+    return g;
+}
+
+//! A uniformly random d-regular graph on n nodes (without loops or multiple edges), by the method of Steger and
+//! Wormald, which is also used by networkx: stubs are paired at random, and pairs which would form a loop or a
+//! repeated edge are put back and paired again.  If the leftover stubs cannot be paired, we start over.
+inline input_graph random_regular(int n, int d, uint64_t seed) {
+    detail::check(n >= 0 && d >= 0 && (d < n || (n == 0 && d == 0)), "random_regular: d must be less than n");
+    detail::check(!((static_cast<int64_t>(n) * d) & 1), "random_regular: n*d must be even");
+    fastrng rng(seed);
+    auto key = [](int a, int b) { return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b); };
+    std::unordered_set<uint64_t> edges;
+    std::vector<int> stubs, leftover;
+    for (bool paired = false; !paired;) {
+        edges.clear();
+        stubs.clear();
+        for (int a = 0; a < n; a++) stubs.insert(stubs.end(), d, a);
+        paired = true;
+        while (stubs.size()) {
+            for (int i = stubs.size(); i > 1; i--) std::swap(stubs[i - 1], stubs[detail::below(rng, i)]);
+            leftover.clear();
+            for (size_t i = 0; i < stubs.size(); i += 2) {
+                int a = stubs[i], b = stubs[i + 1];
+                if (a != b && edges.insert(key(a, b)).second) continue;
+                leftover.push_back(a);
+                leftover.push_back(b);
+            }
+            // give up when no pair of leftover stubs could form a new edge
+            bool suitable = leftover.empty();
+            for (size_t i = 0; i < leftover.size() && !suitable; i++)
+                for (size_t j = i + 1; j < leftover.size() && !suitable; j++)
+                    suitable = leftover[i] != leftover[j] && !edges.count(key(leftover[i], leftover[j]));
+            if (!suitable) {
+                paired = false;
+                break;
+            }
+            stubs.swap(leftover);
+        }
+    }
+    std::vector<uint64_t> sorted(edges.begin(), edges.end());
+    std::sort(sorted.begin(), sorted.end());
+    input_graph g(n, {}, {});
+    for (auto &e : sorted) g.push_back(static_cast<int>(e >> 32), static_cast<int>(e & 0xffffffff));
+    return g;
+}
+
+//! A random geometric graph: n points placed uniformly in the unit square, with an edge between every pair of
+//! points within distance `radius`.  Points are bucketed in cells at least `radius` wide, so only neighboring cells
+//! are compared.  If `points` is given, the coordinates of node i are written to (*points)[2i] and (*points)[2i+1].
+inline input_graph random_geometric(int n, double radius, uint64_t seed, std::vector<double> *points = nullptr) {
+    detail::check(n >= 0 && radius >= 0, "random_geometric: n and radius must be nonnegative");
+    fastrng rng(seed);
+    std::vector<double> xy(2 * n);
+    for (auto &c : xy) c = detail::unit(rng);
+    int side = radius > 0 ? static_cast<int>(std::min(1 / radius, std::sqrt(static_cast<double>(n)) + 1)) : 1;
+    side = std::max(side, 1);
+    auto cell_of = [side](double c) { return std::min(static_cast<int>(c * side), side - 1); };
+    std::vector<std::vector<int>> cells(side * side);
+    for (int a = 0; a < n; a++) cells[cell_of(xy[2 * a]) * side + cell_of(xy[2 * a + 1])].push_back(a);
+
+    input_graph g(n, {}, {});
+    const double r2 = radius * radius;
+    for (int a = 0; a < n; a++) {
+        int cx = cell_of(xy[2 * a]), cy = cell_of(xy[2 * a + 1]);
+        for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, side - 1); x++) {
+            for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, side - 1); y++) {
+                for (auto &b : cells[x * side + y]) {
+                    if (b <= a) continue;
+                    double dx = xy[2 * a] - xy[2 * b], dy = xy[2 * a + 1] - xy[2 * b + 1];
+                    if (dx * dx + dy * dy <= r2) g.push_back(a, b);
+                }
+            }
+        }
+    }
+    if (points != nullptr) points->swap(xy);
+    return g;
+}
+}
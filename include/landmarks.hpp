@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "util.hpp"
+
+namespace find_embedding {
+
+//! Hop distances from a handful of landmark qubits, which bound distances from below through the triangle
+//! inequality: `hops(a, b) >= |hops(L, a) - hops(L, b)|` for every landmark `L`.  Every qubit weighs at least one,
+//! so hop counts also bound the node-weighted distances computed by the pathfinders.  Landmarks are picked by
+//! farthest-point selection, which spreads them over the periphery of the target where the bounds are sharpest.
+class landmark_table {
+    int num_nodes;
+    vector<vector<int>> hops;
+
+  public:
+    //! build the table for the graph with adjacency `nbrs`, from up to `num_landmarks` landmarks
+    landmark_table(const vector<vector<int>> &nbrs, int num_landmarks) : num_nodes(nbrs.size()), hops() {
+        if (num_nodes == 0) return;
+        // the farthest qubit from qubit 0 is the first landmark; each subsequent landmark is the qubit farthest from
+        // all those already picked
+        vector<int> nearest(num_nodes, std::numeric_limits<int>::max());
+        vector<int> scratch;
+        bfs(nbrs, 0, scratch);
+        int next = std::max_element(std::begin(scratch), std::end(scratch)) - std::begin(scratch);
+        while (static_cast<int>(hops.size()) < num_landmarks) {
+            hops.emplace_back();
+            bfs(nbrs, next, hops.back());
+            int far = -1;
+            for (int q = 0; q < num_nodes; q++) {
+                int h = hops.back()[q];
+                if (h >= 0) nearest[q] = min(nearest[q], h);
+                if (nearest[q] != std::numeric_limits<int>::max() && (far < 0 || nearest[q] > nearest[far])) far = q;
+            }
+            if (far < 0 || nearest[far] == 0) break;
+            next = far;
+        }
+    }
+
+    //! the number of landmarks
+    inline int size() const { return hops.size(); }
+
+    //! a lower bound on the number of hops between `a` and `b`
+    inline int lower_bound(const int a, const int b) const {
+        int bound = 0;
+        for (auto &h : hops)
+            if (h[a] >= 0 && h[b] >= 0) bound = max(bound, std::abs(h[a] - h[b]));
+        return bound;
+    }
+
+    //! record, for each landmark, the least and greatest hop counts among `qubits` into `lo` and `hi`
+    template <typename qubits_t>
+    void summarize(const qubits_t &qubits, vector<int> &lo, vector<int> &hi) const {
+        lo.assign(size(), std::numeric_limits<int>::max());
+        hi.assign(size(), -1);
+        for (auto &q : qubits) {
+            for (int i = size(); i--;) {
+                int h = hops[i][q];
+                if (h < 0) continue;
+                lo[i] = min(lo[i], h);
+                hi[i] = max(hi[i], h);
+            }
+        }
+    }
+
+    //! a lower bound on the number of hops between `q` and a set of qubits summarized in `lo` and `hi`
+    inline int lower_bound(const vector<int> &lo, const vector<int> &hi, const int q) const {
+        int bound = 0;
+        for (int i = size(); i--;) {
+            int h = hops[i][q];
+            if (h < 0 || hi[i] < 0) continue;
+            bound = max(bound, max(h - hi[i], lo[i] - h));
+        }
+        return bound;
+    }
+
+    //! returns a table for `nbrs`, shared with every other caller holding one for the same graph.  the cache only
+    //! keeps a fingerprint of each graph and a weak reference to its table, so a table lives as long as its callers
+    //! hold it, and graphs are told apart without copying or comparing their adjacency
+    static std::shared_ptr<const landmark_table> shared(const vector<vector<int>> &nbrs, int num_landmarks) {
+        return shared(nbrs, num_landmarks, fingerprint(nbrs));
+    }
+
+  protected:
+    //! `shared`, with the fingerprint `key` given.  a table found under the same key must also match the number of
+    //! edges, and its hop counts must agree with a sample of the edges of `nbrs`; otherwise, it's taken for a
+    //! collision, and a new table is built
+    static std::shared_ptr<const landmark_table> shared(const vector<vector<int>> &nbrs, int num_landmarks,
+                                                        const uint64_t key) {
+        struct entry {
+            uint64_t key;
+            size_t num_nodes;
+            size_t num_edges;
+            int num_landmarks;
+            std::weak_ptr<const landmark_table> table;
+        };
+        static std::mutex lock;
+        static std::list<entry> cache;
+
+        size_t num_edges = 0;
+        for (auto &n : nbrs) num_edges += n.size();
+        auto find = [&]() {
+            std::shared_ptr<const landmark_table> found;
+            for (auto it = std::begin(cache); it != std::end(cache);) {
+                auto table = it->table.lock();
+                if (!table) {
+                    it = cache.erase(it);
+                    continue;
+                }
+                if (!found && it->key == key && it->num_nodes == nbrs.size() && it->num_edges == num_edges &&
+                    it->num_landmarks == num_landmarks && table->agrees(nbrs))
+                    found = table;
+                ++it;
+            }
+            return found;
+        };
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            auto found = find();
+            if (found) return found;
+        }
+        // the breadth-first searches are run outside the lock; if another caller built the same table meanwhile,
+        // theirs is kept and ours dropped
+        auto table = std::make_shared<const landmark_table>(nbrs, num_landmarks);
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = find();
+        if (found) return found;
+        cache.push_back(entry{key, nbrs.size(), num_edges, num_landmarks, table});
+        return table;
+    }
+
+  private:
+    //! whether the hop counts agree with the edges of `nbrs` at up to `sample_nodes` nodes spread over the graph: the
+    //! ends of an edge are reached together, and their hop counts differ by at most one
+    bool agrees(const vector<vector<int>> &nbrs) const {
+        const int sample_nodes = 64;
+        const int stride = max(1, num_nodes / sample_nodes);
+        for (int q = 0; q < num_nodes; q += stride) {
+            for (auto &p : nbrs[q])
+                for (auto &h : hops)
+                    if ((h[q] < 0) != (h[p] < 0) || std::abs(h[q] - h[p]) > 1) return false;
+        }
+        return true;
+    }
+
+    //! a 64-bit hash of the adjacency lists, taking the degree of each node before its neighbors
+    static uint64_t fingerprint(const vector<vector<int>> &nbrs) {
+        uint64_t h = nbrs.size();
+        auto mix = [&h](uint64_t x) {
+            h = (h ^ x) * UINT64_C(0x9E3779B97F4A7C15);
+            h ^= h >> 29;
+        };
+        for (auto &n : nbrs) {
+            mix(n.size());
+            for (auto &p : n) mix(static_cast<uint32_t>(p));
+        }
+        return h;
+    }
+
+    //! hop counts from `source`, with -1 for unreachable qubits
+    static void bfs(const vector<vector<int>> &nbrs, const int source, vector<int> &h) {
+        h.assign(nbrs.size(), -1);
+        vector<int> level{source}, next;
+        h[source] = 0;
+        for (int d = 1; level.size(); d++) {
+            next.clear();
+            for (auto &q : level)
+                for (auto &p : nbrs[q])
+                    if (h[p] < 0) {
+                        h[p] = d;
+                        next.push_back(p);
+                    }
+            level.swap(next);
+        }
+    }
+};
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace find_embedding {
+
+//! A pool of small, fixed-size blocks, for the nodes of the hash maps which hold chains.  Blocks are carved out of
+//! large slabs and recycled through a free list for each size class, so chains can be cleared and rebuilt over and
+//! over without calling into the system allocator (and without contending on its locks when several threads are
+//! at work).  A pool is not synchronized: it belongs to a single `embedding`, which is only modified by one thread
+//! at a time.
+class node_pool {
+  public:
+    //! blocks are handed out in multiples of `unit` bytes, which keeps them aligned for any node type
+    static constexpr size_t unit = alignof(std::max_align_t);
+    //! the largest block served by the pool is `num_classes * unit` bytes; larger requests go to the heap
+    static constexpr size_t num_classes = 8;
+
+  private:
+    static constexpr size_t slab_size = 1 << 14;
+
+    std::vector<std::unique_ptr<char[]>> slabs;
+    char *cursor;
+    char *slab_end;
+    void *free_list[num_classes];
+
+  public:
+    node_pool() : slabs(), cursor(nullptr), slab_end(nullptr), free_list() {}
+    node_pool(const node_pool &) = delete;
+    node_pool &operator=(const node_pool &) = delete;
+
+    //! true if blocks of `bytes` bytes and alignment `align` are served by the pool
+    static constexpr bool serves(size_t bytes, size_t align) {
+        return bytes <= num_classes * unit && align <= unit;
+    }
+
+    //! get a block of `bytes` bytes.  precondition: `serves(bytes, align)`
+    inline void *allocate(size_t bytes) {
+        size_t c = size_class(bytes);
+        void *p = free_list[c];
+        if (p != nullptr) {
+            free_list[c] = *static_cast<void **>(p);
+            return p;
+        }
+        size_t block = (c + 1) * unit;
+        if (cursor == nullptr || static_cast<size_t>(slab_end - cursor) < block) {
+            slabs.emplace_back(new char[slab_size]);
+            cursor = slabs.back().get();
+            slab_end = cursor + slab_size;
+        }
+        p = cursor;
+        cursor += block;
+        return p;
+    }
+
+    //! return a block obtained from `allocate(bytes)` to the pool
+    inline void deallocate(void *p, size_t bytes) {
+        size_t c = size_class(bytes);
+        *static_cast<void **>(p) = free_list[c];
+        free_list[c] = p;
+    }
+
+    //! release every slab at once.  precondition: no block handed out by this pool is still in use
+    void clear() {
+        slabs.clear();
+        cursor = slab_end = nullptr;
+        for (auto &f : free_list) f = nullptr;
+    }
+
+    //! the number of bytes held in slabs
+    inline size_t capacity() const { return slabs.size() * slab_size; }
+
+  private:
+    static inline size_t size_class(size_t bytes) { return bytes ? (bytes - 1) / unit : 0; }
+};
+
+//! An allocator drawing single objects from a `node_pool`, and anything else (such as the bucket arrays of hash
+//! maps) from the heap.  A default-constructed allocator has no pool and always uses the heap, so containers built
+//! without a pool behave exactly as with `std::allocator`.  Allocators travel with their contents on swap and move,
+//! but not on copy-assignment, so that copying a chain into an embedding fills that embedding's pool.
+template <typename T>
+class pool_allocator {
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    node_pool *pool;
+
+    pool_allocator() noexcept : pool(nullptr) {}
+    explicit pool_allocator(node_pool *p) noexcept : pool(p) {}
+    template <typename U>
+    pool_allocator(const pool_allocator<U> &other) noexcept : pool(other.pool) {}
+
+    inline T *allocate(size_t n) {
+        if (n == 1 && pool != nullptr && node_pool::serves(sizeof(T), alignof(T)))
+            return static_cast<T *>(pool->allocate(sizeof(T)));
+        return std::allocator<T>().allocate(n);
+    }
+
+    inline void deallocate(T *p, size_t n) {
+        if (n == 1 && pool != nullptr && node_pool::serves(sizeof(T), alignof(T)))
+            pool->deallocate(p, sizeof(T));
+        else
+            std::allocator<T>().deallocate(p, n);
+    }
+};
+
+template <typename T, typename U>
+inline bool operator==(const pool_allocator<T> &a, const pool_allocator<U> &b) {
+    return a.pool == b.pool;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const pool_allocator<T> &a, const pool_allocator<U> &b) {
+    return a.pool != b.pool;
+}
+}
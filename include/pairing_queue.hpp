@@ -132,6 +132,7 @@ class pairing_queue {
 
     template <class... Args>
     inline void emplace(Args... args) {
+        minorminer_assert(count < size);
         pairing_node<N> *x = mem + (count++);
         x->refresh(args...);
         root = x->merge_roots(root);
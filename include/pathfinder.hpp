@@ -13,8 +13,10 @@
 #include <vector>
 
 #include "chain.hpp"
+#include "delta_stepping.hpp"
 #include "embedding.hpp"
 #include "embedding_problem.hpp"
+#include "landmarks.hpp"
 #include "util.hpp"
 
 namespace find_embedding {
@@ -36,6 +38,8 @@ template <typename T>
 class pathfinder_serial;
 template <typename T>
 class pathfinder_parallel;
+template <typename T>
+class pathfinder_hybrid;
 
 class pathfinder_public_interface {
   public:
@@ -51,11 +55,16 @@ template <typename embedding_problem_t>
 class pathfinder_base : public pathfinder_public_interface {
     friend class pathfinder_serial<embedding_problem_t>;
     friend class pathfinder_parallel<embedding_problem_t>;
+    friend class pathfinder_hybrid<embedding_problem_t>;
 
   public:
     using embedding_t = embedding<embedding_problem_t>;
+    using distance_t = typename embedding_problem_t::distance_t;
+    static constexpr distance_t max_distance = numeric_limits<distance_t>::max();
 
   protected:
+    using distance_queue = basic_distance_queue<distance_t>;
+
     embedding_problem_t ep;
 
     optional_parameters &params;
@@ -82,11 +91,20 @@ class pathfinder_base : public pathfinder_public_interface {
 
     clock::time_point stoptime;
 
+    //! the per-variable search state is kept in separate rows rather than packed records: the accumulation of
+    //! distances streams through whole rows, permutations are swapped between variables as rows, and the searches
+    //! themselves are dominated by the queue.  benchmarks/search_layout.cpp compares the alternatives
     vector<vector<int>> visited_list;
 
     vector<vector<distance_t>> distances;
     vector<vector<int>> qubit_permutations;
 
+    //! landmarks for the goal-directed searches of `search_radius`, shared between pathfinders on the same target.
+    //! they don't pay for themselves on small targets, where this is left empty
+    std::shared_ptr<const landmark_table> landmarks;
+    static const int landmark_min_qubits = 1024;
+    static const int num_landmarks = 8;
+
   public:
     pathfinder_base(optional_parameters &p_, int &n_v, int &n_f, int &n_q, int &n_r, vector<vector<int>> &v_n,
                     vector<vector<int>> &q_n)
@@ -111,10 +129,17 @@ class pathfinder_base : public pathfinder_public_interface {
               qubit_permutations() {
         vector<int> permutation(num_qubits);
         for (int q = num_qubits; q--;) permutation[q] = q;
-        for (int v = num_vars + num_reserved; v--;) {
+        // one permutation for each variable, fixed or not, since the searches from fixed chains break ties by them too
+        for (int v = num_vars + num_fixed; v--;) {
             ep.shuffle(permutation.begin(), permutation.end());
             qubit_permutations.push_back(permutation);
         }
+        if (num_qubits >= landmark_min_qubits) {
+            // no qubit lists a reserved qubit as its neighbor, so the searches from the landmarks never reach them
+            landmarks = landmark_table::shared(q_n, num_landmarks);
+            probe_distance.resize(num_qubits);
+            probe_stamp.assign(num_qubits, 0);
+        }
     }
 
     void set_initial_chains(map<int, vector<int>> chains) {
@@ -173,11 +198,13 @@ class pathfinder_base : public pathfinder_public_interface {
   protected:
     //! tear out and replace the chain in `emb` for variable `u`
     int find_chain(embedding_t &emb, const int u) {
-        if (ep.embedded || ep.desperate) emb.steal_all(u);
+        if (ep.embedded || ep.desperate) emb.steal_all(u, steiner_space());
         if (ep.embedded) {
+            open_window(emb, u);
             find_short_chain(emb, u, ep.target_chainsize);
             return 1;
         } else {
+            open_window(emb, u);
             emb.tear_out(u);
             return find_chain(emb, u, ep.target_chainsize);
         }
@@ -228,20 +255,22 @@ class pathfinder_base : public pathfinder_public_interface {
             if (pushback < num_vars) {
                 ep.debug("finding a new chain for %d (pushdown)\n", u);
                 int maxfill = 0;
-                emb.steal_all(u);
+                emb.steal_all(u, steiner_space());
                 for (auto &q : emb.get_chain(u)) maxfill = max(maxfill, emb.weight(q));
 
                 ep.weight_bound = max(0, maxfill);
+                open_window(emb, u);
                 emb.freeze_out(u);
                 ;
                 if (!find_chain(emb, u, 0)) {
                     pushback += 3;
                     emb.thaw_back(u);
-                    emb.flip_back(u, 0);
+                    emb.flip_back(u, 0, steiner_space());
                 }
             } else {
                 ep.weight_bound = oldbound;
-                emb.steal_all(u);
+                emb.steal_all(u, steiner_space());
+                open_window(emb, u);
                 emb.tear_out(u);
                 if (!find_chain(emb, u, 0)) {
                     return -1;
@@ -293,27 +322,52 @@ class pathfinder_base : public pathfinder_public_interface {
         }
     }
 
+    //! incorporate the distance from the chain for `v` to `q` into `total_distance[q]`
+    inline void accumulate_distance(const embedding_t &emb, const vector<distance_t> &dist, const vector<int> &visited,
+                                    const int q) {
+        if ((visited[q] == 1) && (total_distance[q] != max_distance) && !(ep.reserved(q)) &&
+            (dist[q] != max_distance) && emb.weight(q) < ep.weight_bound) {
+            total_distance[q] += dist[q];
+        } else {
+            total_distance[q] = max_distance;
+        }
+    }
+
     //! incorporate the distances associated with the chain for `v` into
     //! `total_distance`
     void accumulate_distance(const embedding_t &emb, const int v, vector<int> &visited, const int start,
                              const int stop) {
-        auto dist = distances[v];
-        for (int q = start; q < stop; q++) {
-            if ((visited[q] == 1) && (total_distance[q] != max_distance) && !(ep.reserved(q)) &&
-                (dist[q] != max_distance) && emb.weight(q) < ep.weight_bound) {
-                total_distance[q] += dist[q];
-            } else {
-                total_distance[q] = max_distance;
-            }
-        }
+        const auto &dist = distances[v];
+        for (int q = start; q < stop; q++) accumulate_distance(emb, dist, visited, q);
+    }
+
+    //! as above, over the qubits of the open window.  the searches never leave it, and roots are only taken from it,
+    //! so `total_distance` is neither read nor written elsewhere
+    void accumulate_distance_in_window(const embedding_t &emb, const int v, vector<int> &visited) {
+        const auto &dist = distances[v];
+        for (auto &q : window_qubits) accumulate_distance(emb, dist, visited, q);
     }
 
-    //! a wrapper for `accumulate_distance` and `accumulate_distance_at_chain`
+    //! a wrapper for `accumulate_distance` and `accumulate_distance_at_chain`, which keeps to the window if one is open
     inline void accumulate_distance(const embedding_t &emb, const int v, vector<int> &visited) {
         accumulate_distance_at_chain(emb, v);
-        accumulate_distance(emb, v, visited, 0, num_qubits);
+        if (window_open)
+            accumulate_distance_in_window(emb, v, visited);
+        else
+            accumulate_distance(emb, v, visited, 0, num_qubits);
+    }
+
+    //! reset `total_distance` for the searches on behalf of `u`; only the window is reset if one is open
+    void prepare_total_distance(const int u) {
+        if (window_open)
+            ep.prepare_distances(total_distance, u, max_distance, window_qubits);
+        else
+            ep.prepare_distances(total_distance, u, max_distance);
     }
 
+    //! whether a window is open, confining the searches of the current `find_chain`
+    inline bool windowed() const { return window_open; }
+
   private:
     //! compute the distances from all neighbors of `u` to all qubits
     virtual void prepare_root_distances(const embedding_t &emb, const int u) = 0;
@@ -334,14 +388,26 @@ class pathfinder_base : public pathfinder_public_interface {
 
         prepare_root_distances(emb, u);
 
-        // select a random root among those qubits at minimum heuristic distance
-        collectMinima(total_distance, min_list);
+        // select a random root among those qubits at minimum heuristic distance.  the searches never leave the
+        // window, so every qubit outside of it is out of reach, and only the qubits inside are considered
+        if (window_open) {
+            close_window();
+            collectMinima(total_distance, window_qubits, min_list);
+            if (min_list.empty() || total_distance[min_list[0]] == max_distance) {
+                // no root was found inside the window, so we search the whole target
+                ep.debug("no root in the window for %d, searching globally\n", u);
+                prepare_root_distances(emb, u);
+                collectMinima(total_distance, min_list);
+            }
+        } else {
+            collectMinima(total_distance, min_list);
+        }
 
         int q0 = min_list[ep.randint(0, min_list.size() - 1)];
         if (total_distance[q0] == max_distance) return 0;  // oops all qubits were overfull or unreachable
 
-        emb.construct_chain_steiner(u, q0, parents, distances, visited_list);
-        emb.flip_back(u, target_chainsize);
+        emb.construct_chain_steiner(u, q0, parents, distances, visited_list, steiner_space());
+        emb.flip_back(u, target_chainsize, steiner_space());
 
         return 1;
     }
@@ -351,70 +417,237 @@ class pathfinder_base : public pathfinder_public_interface {
     //! whereas other variants of `find_chain` simply pick a random root candidate with minimum
     //! estimated chainlength.  this procedure takes quite a long time and requires that `emb` is
     //! a valid embedding with no overlaps.
+    //!
+    //! if a window is open, the searches are confined to it.  the old chain for `u` lies in the
+    //! window, and it's kept unless a shorter one is found, so there's no need to fall back on a
+    //! search of the whole target
+    //!
+    //! the searches advance in lockstep, one level at a time.  once every neighbor has expanded
+    //! level `D`, the qubits which have now been reached from all neighbors are candidate roots,
+    //! ordered by the neighbor which reached them last and then by that neighbor's permutation.
+    //! every candidate is evaluated with `chainsize_steiner`, and the first of the shortest is
+    //! kept if it improves on the best so far.  the expansions and the evaluations are divided
+    //! between `worker_threads(degree)` threads, which doesn't change the outcome.
     void find_short_chain(embedding_t &emb, const int u, const int target_chainsize) {
         int last_size = emb.freeze_out(u);
         auto &counts = total_distance;
-        counts.assign(num_qubits, 0);
+        if (window_open)
+            for (auto &q : window_qubits) counts[q] = 0;
+        else
+            counts.assign(num_qubits, 0);
         unsigned int best_size = std::numeric_limits<unsigned int>::max();
-        int q, degree = ep.var_neighbors(u).size();
-        distance_t d;
+        const vector<int> &nbrs = ep.var_neighbors(u, shuffle_first{});
+        const int degree = nbrs.size();
 
         unsigned int stopcheck = static_cast<unsigned int>(max(last_size, target_chainsize));
 
-        vector<distance_queue> PQ;
-        PQ.reserve(ep.var_neighbors(u).size());
-        for (auto &v : ep.var_neighbors(u, shuffle_first{})) {
-            PQ.emplace_back(num_qubits);
-            ep.prepare_visited(visited_list[v], u, v);
-            dijkstra_initialize_chain(emb, v, parents[v], visited_list[v], PQ.back(), embedded_tag{});
-        }
-        for (distance_t D = 0; D <= last_size; D++) {
-            int v_i = 0;
-            for (auto &v : ep.var_neighbors(u)) {
-                auto &pq = PQ[v_i++];
-                auto &parent = parents[v];
-                auto &permutation = qubit_permutations[v];
-                auto &distance = distances[v];
-                auto &visited = visited_list[v];
-                while (!pq.empty()) {
-                    auto z = pq.top();
-                    if (z.dist > D) break;
-                    q = z.node;
-                    distance[q] = d = z.dist;
-                    pq.pop();
-                    if (!emb.weight(q)) counts[q]++;
-
-                    if (counts[q] == degree) {
-                        emb.construct_chain_steiner(u, q, parents, distances, visited_list);
-                        unsigned int cs = emb.chainsize(u);
-                        if (cs < best_size) {
-                            best_size = cs;
-                            if (best_size < stopcheck) goto finish;
-                            emb.freeze_out(u);
-                        } else {
-                            emb.tear_out(u);
-                        }
-                    }
+        if (static_cast<int>(levels.size()) < degree) {
+            levels.resize(degree);
+            next_levels.resize(degree);
+        }
+        for (int i = 0; i < degree; i++) {
+            int v = nbrs[i];
+            levels[i].clear();
+            next_levels[i].clear();
+            level_collector init{levels[i], next_levels[i], distances[v]};
+            prepare_visited(u, v);
+            dijkstra_initialize_chain(emb, v, parents[v], visited_list[v], init, embedded_tag{});
+        }
 
-                    d += 1;
-                    visited[q] = 1;
-                    for (auto &p : ep.qubit_neighbors(q)) {
-                        if (!visited[p]) {
-                            visited[p] = 1;
-                            if (!emb.weight(p)) {
-                                parent[p] = q;
-                                pq.emplace(p, permutation[p], d);
+        const int num_workers = (degree > 1) ? max(1, worker_threads(degree)) : 1;
+        if (static_cast<int>(scratch_space.size()) < num_workers) scratch_space.resize(num_workers);
+        spin_barrier barrier(num_workers);
+        std::atomic<int> next_job(0);
+        bool finished = false, stop = false;
+        const bool unrestricted = params.restrict_chains.empty();
+
+        auto work = [&, this](const int t) {
+            for (distance_t D = 0; D <= last_size; D++) {
+                for (int i; (i = next_job++) < degree;) expand_level(emb, nbrs[i], levels[i], next_levels[i], D + 1);
+                barrier.wait();
+                if (t == 0) {
+                    bool exhausted = true;
+                    candidates.clear();
+                    for (int i = 0; i < degree; i++) {
+                        for (auto &q : levels[i])
+                            if (!emb.weight(q) && ++counts[q] == degree) candidates.push_back(q);
+                        levels[i].swap(next_levels[i]);
+                        next_levels[i].clear();
+                        exhausted &= levels[i].empty();
+                    }
+                    candidate_sizes.resize(candidates.size());
+                    stop = exhausted;
+                    next_job = 0;
+                }
+                barrier.wait();
+                const int num_candidates = candidates.size();
+                for (int j; (j = next_job++) < num_candidates;)
+                    candidate_sizes[j] = emb.chainsize_steiner(u, candidates[j], parents, distances, visited_list,
+                                                               scratch_space[t]);
+                barrier.wait();
+                if (t == 0) {
+                    int chosen = -1;
+                    for (int j = 0; j < num_candidates; j++) {
+                        if (candidate_sizes[j] < best_size) {
+                            best_size = candidate_sizes[j];
+                            chosen = j;
+                            if (best_size < stopcheck) {
+                                finished = true;
+                                break;
                             }
                         }
                     }
+                    if (chosen >= 0) {
+                        emb.construct_chain_steiner(u, candidates[chosen], parents, distances, visited_list,
+                                                    scratch_space[0]);
+                        minorminer_assert(static_cast<unsigned int>(emb.chainsize(u)) == best_size);
+                        if (!finished) emb.freeze_out(u);
+                    }
+                    // without domain restrictions, a root found at a later level is further than `D + 1` from some
+                    // neighbor, along qubits that its chain would have to cover
+                    stop |= finished || (unrestricted && best_size <= D + 1);
+                    next_job = 0;
+                }
+                barrier.wait();
+                if (stop) break;
+            }
+        };
+
+        vector<std::future<void>> workers;
+        for (int t = 1; t < num_workers; t++) workers.push_back(std::async(std::launch::async, work, t));
+        work(0);
+        for (auto &w : workers) w.wait();
+
+        close_window();
+        if (!finished) emb.thaw_back(u);
+        emb.flip_back(u, target_chainsize, steiner_space());
+    }
+
+    //! the number of threads that `find_short_chain` may use for a variable with `degree` neighbors
+    virtual int worker_threads(int) const { return 1; }
+
+    //! scratch space for the chain operations of the embedding, outside of `find_short_chain`'s workers
+    inline steiner_scratch &steiner_space() {
+        if (scratch_space.empty()) scratch_space.resize(1);
+        return scratch_space[0];
+    }
+
+    //! the window for the next call to `find_chain`, when `window_open` is set: the qubits of `window_qubits`, in the
+    //! order they were reached, and `window_ring`, the qubits next to the window but outside of it.  the sources of
+    //! the searches all lie in the window, so masking the ring keeps the searches inside.  `window_stamp` marks the
+    //! qubits of both while the window is built
+    vector<int> window_stamp;
+    int window_generation = 0;
+    bool window_open = false;
+    vector<int> window_qubits;
+    vector<int> window_ring;
+
+    //! when a `placement_window` is given, confine the searches of the next `find_chain` for `u` to the qubits within
+    //! that many hops of its chain and the chains of its embedded neighbors.  this is only done after initialization,
+    //! where the new chain for `u` usually lands near the old one, and it must be called while `u` holds its chain.
+    //! without an embedded neighbor, there are no searches to confine, and no window is opened
+    void open_window(const embedding_t &emb, const int u) {
+        window_open = false;
+        if (params.placement_window <= 0 || !ep.initialized || !emb.chainsize(u)) return;
+        bool searched = false;
+        for (auto &v : ep.var_neighbors(u)) searched |= emb.chainsize(v) > 0;
+        if (!searched) return;
+        if (window_stamp.empty()) window_stamp.assign(num_qubits, 0);
+        if (++window_generation == std::numeric_limits<int>::max()) {
+            std::fill(std::begin(window_stamp), std::end(window_stamp), 0);
+            window_generation = 1;
+        }
+        window_qubits.clear();
+        window_ring.clear();
+        auto include = [this](vector<int> &list, const int q) {
+            if (window_stamp[q] != window_generation) {
+                window_stamp[q] = window_generation;
+                list.push_back(q);
+            }
+        };
+        // the qubits of fixed chains are reserved, so their neighbors are taken in their place
+        auto include_chain = [&, this](const int v) {
+            for (auto &q : emb.get_chain(v)) {
+                if (ep.fixed(v))
+                    for (auto &p : ep.qubit_neighbors(q)) include(window_qubits, p);
+                else
+                    include(window_qubits, q);
+            }
+        };
+        include_chain(u);
+        for (auto &v : ep.var_neighbors(u))
+            if (emb.chainsize(v)) include_chain(v);
+        // a breadth-first search, where the qubits in `window_qubits` from `level` on are the last level reached
+        size_t level = 0;
+        for (int d = params.placement_window; d--;) {
+            size_t next = window_qubits.size();
+            for (size_t i = level; i < next; i++)
+                for (auto &p : ep.qubit_neighbors(window_qubits[i])) include(window_qubits, p);
+            level = next;
+        }
+        for (size_t i = level; i < window_qubits.size(); i++)
+            for (auto &p : ep.qubit_neighbors(window_qubits[i])) include(window_ring, p);
+        window_open = true;
+    }
+
+    inline void close_window() { window_open = false; }
+
+  protected:
+    //! prepare `visited_list[v]` for a search from the chain of `v`, on behalf of `u`.  if a window is open, only
+    //! the window is prepared, and the ring around it is masked; the search never reads the qubits beyond
+    void prepare_visited(const int u, const int v) {
+        vector<int> &visited = visited_list[v];
+        if (window_open) {
+            ep.prepare_visited(visited, u, v, window_qubits);
+            for (auto &q : window_ring) visited[q] = -1;
+        } else {
+            ep.prepare_visited(visited, u, v);
+        }
+    }
+
+  private:
+    //! per-neighbor frontiers and candidate roots for `find_short_chain`, and scratch space for each worker
+    vector<vector<int>> levels;
+    vector<vector<int>> next_levels;
+    vector<int> candidates;
+    vector<unsigned int> candidate_sizes;
+    vector<steiner_scratch> scratch_space;
+
+    //! sorts the frontier of the search from `v`, so that it's expanded in the order that a priority queue would pop it,
+    //! and collects the newly discovered qubits at distance `d` into `next`.  distances are recorded as qubits are
+    //! discovered rather than expanded, so that every visited qubit has a distance when candidates are evaluated
+    void expand_level(const embedding_t &emb, const int v, vector<int> &level, vector<int> &next, const distance_t d) {
+        auto &parent = parents[v];
+        auto &permutation = qubit_permutations[v];
+        auto &distance = distances[v];
+        auto &visited = visited_list[v];
+        std::sort(std::begin(level), std::end(level),
+                  [&permutation](const int a, const int b) { return permutation[a] < permutation[b]; });
+        for (auto &q : level) {
+            for (auto &p : ep.qubit_neighbors(q)) {
+                if (!visited[p]) {
+                    visited[p] = 1;
+                    if (!emb.weight(p)) {
+                        parent[p] = q;
+                        distance[p] = d;
+                        next.push_back(p);
+                    }
                 }
             }
         }
-        emb.thaw_back(u);
-    finish:
-        emb.flip_back(u, target_chainsize);
     }
 
+    //! collects the sources of a search into the first two levels for `find_short_chain`
+    struct level_collector {
+        vector<int> &level;
+        vector<int> &next;
+        vector<distance_t> &distance;
+        inline void emplace(int q, int, distance_t d) {
+            distance[q] = d;
+            (d ? next : level).push_back(q);
+        }
+    };
+
   private:
     struct embedded_tag {};
     struct default_tag {};
@@ -431,18 +664,19 @@ class pathfinder_base : public pathfinder_public_interface {
         // scan through the qubits.
         // * qubits in the chain of v have distance 0,
         // * overfull qubits are tagged as visited with a special value of -1
+        // * qubits adjacent to several qubits of a fixed chain are only queued once, the queue holds num_qubits nodes
         if (ep.fixed(v)) {
             for (auto &q : emb.get_chain(v)) {
                 parent[q] = -1;
                 for (auto &p : ep.qubit_neighbors(q)) {
                     if (std::is_same<behavior_tag, embedded_tag>::value)
                         if (emb.weight(p) == 0) {
-                            pq.emplace(p, permutation[p], 1);
+                            if (visited[p] != 1) pq.emplace(p, permutation[p], 1);
                             parent[p] = q;
                             visited[p] = 1;
                         }
                     if (std::is_same<behavior_tag, default_tag>::value) {
-                        pq.emplace(p, permutation[p], qubit_weight[p]);
+                        if (visited[p] != 1) pq.emplace(p, permutation[p], qubit_weight[p]);
                         parent[p] = q;
                         visited[p] = 1;
                     }
@@ -460,8 +694,10 @@ class pathfinder_base : public pathfinder_public_interface {
   protected:
     //! run dijkstra's algorithm, seeded at the chain for `v`, using the `visited` vector
     //! note: qubits are only visited if `visited[q] = 1`.  the value `-1` is used to prevent
-    //! searching of overfull qubits
-    void compute_distances_from_chain(const embedding_t &emb, const int &v, vector<int> &visited) {
+    //! searching of overfull qubits.  qubits further than `radius` from the chain are not
+    //! expanded, and their distance is recorded as `max_distance`
+    void compute_distances_from_chain(const embedding_t &emb, const int &v, vector<int> &visited,
+                                      const distance_t radius = max_distance) {
         distance_queue pq(num_qubits);
         auto &parent = parents[v];
         auto &permutation = qubit_permutations[v];
@@ -473,6 +709,11 @@ class pathfinder_base : public pathfinder_public_interface {
         while (!pq.empty()) {
             auto z = pq.top();
             pq.pop();
+            if (z.dist > radius) {
+                // only the neighbors of a fixed chain can be queued beyond the radius
+                distance[z.node] = max_distance;
+                continue;
+            }
             distance[z.node] = z.dist;
             for (auto &p : ep.qubit_neighbors(z.node)) {
                 if (!visited[p]) {
@@ -481,11 +722,91 @@ class pathfinder_base : public pathfinder_public_interface {
                         distance[p] = max_distance;
                     } else {
                         parent[p] = z.node;
-                        pq.emplace(p, permutation[p], z.dist + qubit_weight[p]);
+                        distance_t d = z.dist + qubit_weight[p];
+                        if (d > radius)
+                            distance[p] = max_distance;
+                        else
+                            pq.emplace(p, permutation[p], d);
+                    }
+                }
+            }
+        }
+    }
+
+    //! the searches and accumulation of `prepare_root_distances`: run `compute_distances_from_chain` from the chain of
+    //! each embedded neighbor of `u`, out to `radius`, and accumulate the distances into `total_distance`
+    void compute_distances_from_neighbors(const embedding_t &emb, const int u, const distance_t radius) {
+        for (auto &v : ep.var_neighbors(u)) {
+            if (!emb.chainsize(v)) continue;
+            compute_distances_from_chain(emb, v, visited_list[v], radius);
+            accumulate_distance(emb, v, visited_list[v]);
+        }
+    }
+
+    //! an upper bound on the least total distance that `prepare_root_distances` will find for `u`, so that the
+    //! searches from its neighbors can stop at that radius: roots at least total distance, and the shortest paths
+    //! that `construct_chain_steiner` follows from them, lie within it.  the bound is the exact total distance of a
+    //! probe qubit beside a neighboring chain, chosen by landmark lower bounds and measured by A* searches.  this
+    //! expects `qubit_weight`, `total_distance` and the `visited_list` of each embedded neighbor to be prepared, and
+    //! returns `max_distance` if there are no landmarks or no suitable probe
+    distance_t search_radius(const embedding_t &emb, const int u) {
+        if (!landmarks || ep.weight_bound <= 0) return max_distance;
+        const landmark_table &table = *landmarks;
+
+        probe_nbrs.clear();
+        for (auto &v : ep.var_neighbors(u))
+            if (emb.chainsize(v)) probe_nbrs.push_back(v);
+        const int degree = probe_nbrs.size();
+        if (!degree) return max_distance;
+
+        // probes are taken beside the neighboring chains, and scored by the sum of their lower bounds
+        if (static_cast<int>(probe_lo.size()) < degree) {
+            probe_lo.resize(degree);
+            probe_hi.resize(degree);
+        }
+        next_probe_generation();
+        for (int i = 0; i < degree; i++) {
+            int v = probe_nbrs[i];
+            probe_seeds.clear();
+            for (auto &q : emb.get_chain(v)) {
+                if (!ep.fixed(v)) probe_seeds.push_back(q);
+                for (auto &p : ep.qubit_neighbors(q)) {
+                    if (ep.fixed(v)) probe_seeds.push_back(p);
+                    if (probe_stamp[p] != probe_generation) {
+                        probe_stamp[p] = probe_generation;
+                        probe_candidates.push_back(p);
                     }
                 }
             }
+            table.summarize(probe_seeds, probe_lo[i], probe_hi[i]);
+        }
+
+        int probe = -1;
+        long long best_score = 0;
+        for (auto &c : probe_candidates) {
+            if (total_distance[c] == max_distance || emb.weight(c)) continue;
+            long long score = 0;
+            bool open = true;
+            for (int i = 0; open && i < degree; i++) {
+                open = !visited_list[probe_nbrs[i]][c];
+                score += table.lower_bound(probe_lo[i], probe_hi[i], c);
+            }
+            if (open && (probe < 0 || score < best_score)) {
+                best_score = score;
+                probe = c;
+            }
+        }
+        probe_candidates.clear();
+        if (probe < 0) return max_distance;
+
+        distance_t radius = 0;
+        int budget = num_qubits / 4;
+        for (auto &v : probe_nbrs) {
+            distance_t d = probe_distance_from_chain(emb, v, probe, budget);
+            if (d > max_distance - radius) return max_distance;
+            radius += d;
         }
+        return radius;
     }
 
     //! compute the weight of each qubit, first selecting `alpha`
@@ -503,6 +824,74 @@ class pathfinder_base : public pathfinder_public_interface {
         for (int q = start; q < stop; q++) qubit_weight[q] = ep.weight(emb.weight(q));
     }
 
+  private:
+    //! scratch space for `search_radius`.  the probe searches keep their own distances, which are valid where
+    //! `probe_stamp` matches `probe_generation`, so that they don't disturb the searches that follow them
+    vector<int> probe_nbrs;
+    vector<int> probe_seeds;
+    vector<int> probe_candidates;
+    vector<vector<int>> probe_lo;
+    vector<vector<int>> probe_hi;
+    vector<distance_t> probe_distance;
+    vector<int> probe_stamp;
+    int probe_generation = 0;
+
+    struct probe_entry {
+        distance_t bound;
+        distance_t dist;
+        int node;
+        //! heap order: least bound first, and the furthest along among equal bounds
+        inline bool operator<(const probe_entry &other) const {
+            return bound > other.bound || (bound == other.bound && dist < other.dist);
+        }
+    };
+    vector<probe_entry> probe_heap;
+
+    void next_probe_generation() {
+        if (++probe_generation == std::numeric_limits<int>::max()) {
+            std::fill(std::begin(probe_stamp), std::end(probe_stamp), 0);
+            probe_generation = 1;
+        }
+    }
+
+    //! the distance that `compute_distances_from_chain` would find from the chain of `v` to `target`, by an A* search
+    //! over the same qubits, guided by the landmark bounds.  every qubit weighs at least `ep.weight(0)`, so the
+    //! bounds are consistent, and `target` has its final distance when it's first popped.  the search gives up,
+    //! returning `max_distance`, once it has expanded `budget` qubits between calls
+    distance_t probe_distance_from_chain(const embedding_t &emb, const int v, const int target, int &budget) {
+        const landmark_table &table = *landmarks;
+        const distance_t unit = ep.weight(0);
+        auto &visited = visited_list[v];
+        next_probe_generation();
+        probe_heap.clear();
+        auto relax = [&, this](const int q, const distance_t d) {
+            if (probe_stamp[q] == probe_generation && probe_distance[q] <= d) return;
+            probe_stamp[q] = probe_generation;
+            probe_distance[q] = d;
+            probe_heap.push_back(probe_entry{d + unit * table.lower_bound(q, target), d, q});
+            std::push_heap(std::begin(probe_heap), std::end(probe_heap));
+        };
+
+        // the same sources as dijkstra_initialize_chain
+        for (auto &q : emb.get_chain(v)) {
+            if (ep.fixed(v))
+                for (auto &p : ep.qubit_neighbors(q)) relax(p, qubit_weight[p]);
+            else
+                relax(q, 0);
+        }
+        while (!probe_heap.empty()) {
+            std::pop_heap(std::begin(probe_heap), std::end(probe_heap));
+            probe_entry z = probe_heap.back();
+            probe_heap.pop_back();
+            if (z.dist != probe_distance[z.node]) continue;
+            if (z.node == target) return z.dist;
+            if (!budget--) break;
+            for (auto &p : ep.qubit_neighbors(z.node))
+                if (!visited[p] && emb.weight(p) < ep.weight_bound) relax(p, z.dist + qubit_weight[p]);
+        }
+        return max_distance;
+    }
+
   public:
     virtual void quickPass(VARORDER varorder, int chainlength_bound, int overlap_bound, bool local_search,
                            bool clear_first, double round_beta) {
@@ -526,7 +915,7 @@ class pathfinder_base : public pathfinder_public_interface {
         for (auto &u : varorder) {
             lastsize = bestEmbedding.chainsize(u);
             if (lastsize) {
-                bestEmbedding.steal_all(u);
+                bestEmbedding.steal_all(u, steiner_space());
                 lastsize = bestEmbedding.chainsize(u);
             }
 
@@ -550,7 +939,7 @@ class pathfinder_base : public pathfinder_public_interface {
 
             if (got) {
                 if (bestEmbedding.chainsize(u) > chainlength_bound && chainlength_bound > 0) {
-                    bestEmbedding.steal_all(u);
+                    bestEmbedding.steal_all(u, steiner_space());
                     bestEmbedding.tear_out(u);
                 }
             }
@@ -558,6 +947,94 @@ class pathfinder_base : public pathfinder_public_interface {
         ep.weight_bound = old_bound;
     }
 
+  private:
+    //! the total overlap of `emb`: the number of chains on each qubit beyond the first, summed over all qubits.  the
+    //! adaptive schedule measures progress by it, since it falls smoothly as the overfill passes do their work
+    long long total_overlap(const embedding_t &emb) {
+        long long overlap = 0;
+        if (emb.statistics(schedule_stats)) return 0;
+        for (int i = schedule_stats.size(); i--;) overlap += static_cast<long long>(i + 1) * schedule_stats[i];
+        return overlap;
+    }
+
+    vector<int> schedule_stats;
+
+    //! the overfill phase under `params.adaptive_schedule`, which runs until an embedding is found or time runs out.
+    //! each pass type keeps a running estimate of the overlap it removes per second, and the most productive is run
+    //! next; a pass type left idle for a while is retried, so that its estimate follows the embedding as it changes.
+    //! once the current embedding has gone without improvement for half of its lifetime, it is abandoned and a new
+    //! one is initialized from the initial chains (the best embedding found so far is kept all along).  a quarter of
+    //! the way there, passes are made desperate
+    void adaptive_overfill_phase() {
+        enum pass_kind { PASS_PUSHDOWN, PASS_IMPROVE, PASS_KINDS };
+        const int reprobe_interval = 8;
+        double rate[PASS_KINDS] = {0, 0};
+        int samples[PASS_KINDS] = {0, 0};
+        int idle[PASS_KINDS] = {0, 0};
+
+        auto seconds = [](clock::duration d) { return std::chrono::duration<double>(d).count(); };
+        auto lineage_start = clock::now(), last_gain = lineage_start;
+        int stalled_passes = 0;
+        long long overlap = total_overlap(currEmbedding);
+
+        while (!ep.embedded) {
+            auto now = clock::now();
+            double age = seconds(now - lineage_start), stall = seconds(now - last_gain);
+            if (stalled_passes >= 2 * PASS_KINDS && stall > age / 2) {
+                ep.extra_info("restarting from the initial chains after %d passes without improvement\n",
+                              stalled_passes);
+                ep.initialized = ep.desperate = 0;
+                currEmbedding = initEmbedding;
+                int r = initialization_pass(currEmbedding);
+                if (r == -2) break;
+                if (r == -1)
+                    currEmbedding = bestEmbedding;
+                else
+                    check_improvement(currEmbedding);
+                ep.initialized = 1;
+                lineage_start = last_gain = clock::now();
+                stalled_passes = 0;
+                overlap = total_overlap(currEmbedding);
+                continue;
+            }
+            ep.desperate = stalled_passes >= PASS_KINDS && stall > age / 4;
+
+            pass_kind kind;
+            if (samples[PASS_PUSHDOWN] == 0 || idle[PASS_PUSHDOWN] > reprobe_interval)
+                kind = PASS_PUSHDOWN;
+            else if (samples[PASS_IMPROVE] == 0 || idle[PASS_IMPROVE] > reprobe_interval)
+                kind = PASS_IMPROVE;
+            else
+                kind = (rate[PASS_IMPROVE] > rate[PASS_PUSHDOWN]) ? PASS_IMPROVE : PASS_PUSHDOWN;
+            for (auto &i : idle) i++;
+            idle[kind] = 0;
+
+            ep.extra_info("%s pass, max qubit fill %d, num max qubits %d\n",
+                          kind == PASS_PUSHDOWN ? "pushdown" : "overfill improvement", best_stats.size() + 1,
+                          best_stats.back());
+            pushback = 0;
+            int r = (kind == PASS_PUSHDOWN) ? pushdown_overfill_pass(currEmbedding)
+                                            : improve_overfill_pass(currEmbedding);
+            if (r == -2) break;
+            if (r == -1) currEmbedding = bestEmbedding;
+            ep.improved = (r == 1);
+
+            long long next_overlap = total_overlap(currEmbedding);
+            long long gain = (r == -1) ? 0 : max(0LL, overlap - next_overlap);
+            double elapsed = max(seconds(clock::now() - now), 1e-9);
+            rate[kind] = (samples[kind]++) ? rate[kind] + (gain / elapsed - rate[kind]) / 4 : gain / elapsed;
+            if (gain > 0) {
+                last_gain = clock::now();
+                stalled_passes = 0;
+            } else {
+                stalled_passes++;
+            }
+            overlap = next_overlap;
+        }
+        ep.desperate = 0;
+    }
+
+  public:
     //! perform the heuristic embedding, returning 1 if an embedding was found and 0 otherwise
     virtual int heuristicEmbedding() override {
         auto timeout0 = duration<double>(params.timeout);
@@ -586,7 +1063,8 @@ class pathfinder_base : public pathfinder_public_interface {
         check_improvement(currEmbedding);
         ep.improved = 1;
         currEmbedding = bestEmbedding;
-        for (int trial_patience = params.tries; trial_patience-- && (!ep.embedded);) {
+        if (params.adaptive_schedule) adaptive_overfill_phase();
+        for (int trial_patience = params.adaptive_schedule ? 0 : params.tries; trial_patience-- && (!ep.embedded);) {
             int improvement_patience = params.max_no_improvement;
             ep.major_info("embedding trial %d\n", params.tries - trial_patience);
             pushback = 0;
@@ -675,12 +1153,17 @@ class pathfinder_base : public pathfinder_public_interface {
     }
 };
 
+template <typename embedding_problem_t>
+constexpr typename pathfinder_base<embedding_problem_t>::distance_t pathfinder_base<embedding_problem_t>::max_distance;
+
 //! A pathfinder where the Dijkstra-from-neighboring-chain passes are done serially.
 template <typename embedding_problem_t>
 class pathfinder_serial : public pathfinder_base<embedding_problem_t> {
   public:
     using super = pathfinder_base<embedding_problem_t>;
     using embedding_t = embedding<embedding_problem_t>;
+    using distance_t = typename super::distance_t;
+    using super::max_distance;
 
   private:
   public:
@@ -690,63 +1173,53 @@ class pathfinder_serial : public pathfinder_base<embedding_problem_t> {
     virtual ~pathfinder_serial() {}
 
     virtual void prepare_root_distances(const embedding_t &emb, const int u) override {
-        super::ep.prepare_distances(super::total_distance, u, max_distance);
+        super::prepare_total_distance(u);
         super::compute_qubit_weights(emb);
 
-        // run Dijkstra's algorithm from each neighbor to compute distances and shortest paths to neighbor's chains
         int neighbors_embedded = 0;
         for (auto &v : super::ep.var_neighbors(u)) {
             if (!emb.chainsize(v)) continue;
             neighbors_embedded++;
-            super::ep.prepare_visited(super::visited_list[v], u, v);
-            super::compute_distances_from_chain(emb, v, super::visited_list[v]);
-            super::accumulate_distance(emb, v, super::visited_list[v]);
+            super::prepare_visited(u, v);
         }
 
+        // run Dijkstra's algorithm from each neighbor to compute distances and shortest paths to neighbor's chains
+        distance_t radius = super::search_radius(emb, u);
+        super::compute_distances_from_neighbors(emb, u, radius);
+
         if (!neighbors_embedded)
             for (int q = super::num_qubits; q--;)
                 if (emb.weight(q) >= super::ep.weight_bound) super::total_distance[q] = max_distance;
     }
 };
 
-//! A pathfinder where the Dijkstra-from-neighboring-chain passes are done serially.
+//! A pathfinder where the Dijkstra-from-neighboring-chain passes are done in parallel.
 template <typename embedding_problem_t>
 class pathfinder_parallel : public pathfinder_base<embedding_problem_t> {
   public:
     using super = pathfinder_base<embedding_problem_t>;
     using embedding_t = embedding<embedding_problem_t>;
+    using distance_t = typename super::distance_t;
+    using super::max_distance;
 
-  private:
+  protected:
     int num_threads;
     vector<std::future<void>> futures;
     vector<int> thread_weight;
-    mutex get_job;
 
-    unsigned int nbr_i;
+    //! the embedded neighbors of the variable being placed, in the order of `var_neighbors`.  threads claim them by
+    //! index, and each search writes only to the buffers of its own neighbor, so the distances computed do not depend
+    //! on the number of threads or on how they are scheduled
+    vector<int> embedded_nbrs;
+    std::atomic<unsigned int> nbr_i;
     int neighbors_embedded;
 
-    void run_in_thread(const embedding_t &emb, const int u) {
-        get_job.lock();
-        while (1) {
-            int v = -1;
-            const vector<int> &neighbors = super::ep.var_neighbors(u);
-            while (nbr_i < neighbors.size()) {
-                int v0 = neighbors[nbr_i++];
-                if (emb.chainsize(v0)) {
-                    v = v0;
-                    neighbors_embedded++;
-                    break;
-                }
-            }
-            get_job.unlock();
-
-            if (v < 0) break;
-
-            vector<int> &visited = super::visited_list[v];
-            super::ep.prepare_visited(visited, u, v);
-            super::compute_distances_from_chain(emb, v, visited);
-
-            get_job.lock();
+    //! the searches of a fan-out, out to `radius`.  the visited lists are prepared here unless `prepared`
+    void run_in_thread(const embedding_t &emb, const int u, const distance_t radius, const bool prepared) {
+        for (unsigned int i; (i = nbr_i++) < embedded_nbrs.size();) {
+            int v = embedded_nbrs[i];
+            if (!prepared) super::prepare_visited(u, v);
+            super::compute_distances_from_chain(emb, v, super::visited_list[v], radius);
         }
     }
 
@@ -778,35 +1251,75 @@ class pathfinder_parallel : public pathfinder_base<embedding_problem_t> {
         for (int i = num_threads; i--;) futures[i].wait();
     }
 
+    //! each worker of `find_short_chain` expands the levels of some neighbors, so it runs inline unless every thread
+    //! gets a neighbor
+    virtual int worker_threads(int degree) const override { return (degree < num_threads) ? 1 : num_threads; }
+
   public:
     pathfinder_parallel(optional_parameters &p_, int n_v, int n_f, int n_q, int n_r, vector<vector<int>> &v_n,
                         vector<vector<int>> &q_n)
             : super(p_, n_v, n_f, n_q, n_r, v_n, q_n),
               num_threads(min(p_.threads, n_q)),
               futures(num_threads),
-              thread_weight(num_threads) {}
+              thread_weight(num_threads),
+              embedded_nbrs(),
+              nbr_i(0),
+              neighbors_embedded(0) {}
     virtual ~pathfinder_parallel() {}
 
     virtual void prepare_root_distances(const embedding_t &emb, const int u) override {
+        prepare_weights(emb, u);
+
+        embedded_nbrs.clear();
+        for (auto &v : super::ep.var_neighbors(u))
+            if (emb.chainsize(v)) embedded_nbrs.push_back(v);
+        neighbors_embedded = embedded_nbrs.size();
+
+        // the radius is found once, here, and shared by the searches.  it needs every visited list first, which
+        // are otherwise prepared by the threads
+        const bool prepared = static_cast<bool>(super::landmarks);
+        distance_t radius = max_distance;
+        if (prepared) {
+            for (auto &v : embedded_nbrs) super::prepare_visited(u, v);
+            radius = super::search_radius(emb, u);
+        }
+
+        nbr_i = 0;
+        for (int i = 0; i < num_threads; i++)
+            futures[i] = std::async(std::launch::async,
+                                    [this, &emb, u, radius, prepared]() { run_in_thread(emb, u, radius, prepared); });
+        for (int i = 0; i < num_threads; i++) futures[i].wait();
+
+        accumulate_all(emb, u);
+    }
+
+  protected:
+    //! compute the qubit weights and reset `total_distance`, split between threads
+    void prepare_weights(const embedding_t &emb, const int u) {
         exec_indexed([this, &emb](int i, int a, int b) { thread_weight[i] = emb.max_weight(a, b); });
 
         int maxwid = *std::max_element(begin(thread_weight), end(thread_weight));
         super::ep.populate_weight_table(maxwid);
 
-        exec_chunked([this, &emb, u](int a, int b) {
+        const bool windowed = super::windowed();
+        exec_chunked([this, &emb, u, windowed](int a, int b) {
             super::compute_qubit_weights(emb, a, b);
-            this->ep.prepare_distances(this->total_distance, u, max_distance, a, b);
+            if (!windowed) this->ep.prepare_distances(this->total_distance, u, max_distance, a, b);
         });
+        if (windowed) super::prepare_total_distance(u);
+    }
 
-        nbr_i = 0;
-        neighbors_embedded = 0;
-        for (int i = 0; i < num_threads; i++)
-            futures[i] = std::async(std::launch::async, [this, &emb, &u]() { run_in_thread(emb, u); });
-        for (int i = 0; i < num_threads; i++) futures[i].wait();
-
+    //! sum the distances from each embedded neighbor of `u` into `total_distance`, split between threads
+    void accumulate_all(const embedding_t &emb, const int u) {
         for (auto &v : super::ep.var_neighbors(u)) {
             super::accumulate_distance_at_chain(emb, v);  // this isn't parallel but at least it should be sparse?
         }
+        // a window is small, and is accumulated here rather than split between threads
+        if (super::windowed()) {
+            for (auto &v : super::ep.var_neighbors(u))
+                if (emb.chainsize(v)) super::accumulate_distance_in_window(emb, v, super::visited_list[v]);
+            return;
+        }
 
         exec_chunked([this, &emb, u](int a, int b) {
             for (auto &v : super::ep.var_neighbors(u)) {
@@ -820,4 +1333,220 @@ class pathfinder_parallel : public pathfinder_base<embedding_problem_t> {
         });
     }
 };
+
+//! A pathfinder which decides, for each chain placement, whether to run the Dijkstra-from-neighboring-chain passes
+//! inline, to fan them out between threads as pathfinder_parallel does, or to split each search and the qubit-linear
+//! work between threads.  Thread launches don't pay for themselves on variables of low degree, so
+//! the decision is made from the number of embedded neighbors, the number of qubits, and running estimates of the cost
+//! of each strategy on earlier calls.  Every strategy computes the same distances, so the embedding found does not
+//! depend on the decisions made here.
+template <typename embedding_problem_t>
+class pathfinder_hybrid : public pathfinder_parallel<embedding_problem_t> {
+  public:
+    using super = pathfinder_base<embedding_problem_t>;
+    using parallel = pathfinder_parallel<embedding_problem_t>;
+    using embedding_t = embedding<embedding_problem_t>;
+    using distance_t = typename super::distance_t;
+    using super::max_distance;
+
+  private:
+    using delta_stepping = basic_delta_stepping<distance_t>;
+    enum hybrid_mode { HYBRID_INLINE, HYBRID_FANOUT, HYBRID_SPLIT, HYBRID_MODES };
+
+    //! running estimates in seconds: the qubit-linear work of an inline call, the search and accumulation for a single
+    //! neighbor, and for each threaded mode, the time lost to launches and load imbalance beyond a perfect split
+    double base_cost;
+    double search_cost;
+    double excess[HYBRID_MODES];
+    //! the number of samples behind `base_cost`, and behind `search_cost` and the two excesses, by mode.  every inline
+    //! call samples `base_cost`, but only those with an embedded neighbor sample `search_cost`
+    int base_samples;
+    int samples[HYBRID_MODES];
+
+    //! calls since each mode was last used -- a mode left idle for `reprobe_interval` calls is retried, so that its
+    //! estimate follows the changing costs as the embedding evolves
+    int idle[HYBRID_MODES];
+    static const int reprobe_interval = 256;
+
+    //! the split searches, by delta-stepping with buckets the width of the weight of an empty qubit
+    delta_stepping sssp;
+    vector<typename delta_stepping::entry> sources;
+
+    struct source_list {
+        vector<typename delta_stepping::entry> &sources;
+        inline void emplace(int q, int, distance_t d) { sources.emplace_back(q, d); }
+    };
+
+    static void update_estimate(double &estimate, int &count, double sample) {
+        estimate = (count++) ? estimate + (sample - estimate) / 8 : sample;
+    }
+
+    static double seconds(clock::duration d) { return std::chrono::duration<double>(d).count(); }
+
+    //! `find_short_chain` expands the levels of the searches from the neighbors as a fan-out runs the searches
+    //! themselves, and pays for a launch of its workers and a few barriers per level besides.  so it only runs threaded
+    //! when a fan-out over the same neighbors is measured to pay for its launches
+    virtual int worker_threads(int degree) const override {
+        const int T = parallel::num_threads;
+        if (T < 2 || degree < T || !samples[HYBRID_FANOUT]) return 1;
+        double saved = (degree - (degree + T - 1) / T) * search_cost;
+        return (excess[HYBRID_FANOUT] < saved) ? T : 1;
+    }
+
+    hybrid_mode choose_mode(int degree) {
+        const int T = parallel::num_threads;
+        if (T < 2 || degree == 0 || samples[HYBRID_INLINE] < 4) return HYBRID_INLINE;
+
+        bool fanout_ok = degree > 1;
+        if (idle[HYBRID_INLINE] > reprobe_interval) return HYBRID_INLINE;
+        if (fanout_ok && idle[HYBRID_FANOUT] > reprobe_interval) return HYBRID_FANOUT;
+        if (idle[HYBRID_SPLIT] > reprobe_interval) return HYBRID_SPLIT;
+
+        double cost[HYBRID_MODES];
+        cost[HYBRID_INLINE] = base_cost + degree * search_cost;
+        cost[HYBRID_FANOUT] = base_cost / T + ((degree + T - 1) / T) * search_cost + excess[HYBRID_FANOUT];
+        cost[HYBRID_SPLIT] = (base_cost + degree * search_cost) / T + excess[HYBRID_SPLIT];
+        if (!fanout_ok) cost[HYBRID_FANOUT] = std::numeric_limits<double>::infinity();
+
+        hybrid_mode mode = HYBRID_INLINE;
+        for (auto m : {HYBRID_FANOUT, HYBRID_SPLIT})
+            if (cost[m] < cost[mode]) mode = m;
+        return mode;
+    }
+
+    void prepare_inline(const embedding_t &emb, const int u, const int degree) {
+        auto t0 = clock::now();
+        super::prepare_total_distance(u);
+        super::compute_qubit_weights(emb);
+        auto t1 = clock::now();
+
+        for (auto &v : super::ep.var_neighbors(u))
+            if (emb.chainsize(v)) super::prepare_visited(u, v);
+        distance_t radius = super::search_radius(emb, u);
+        super::compute_distances_from_neighbors(emb, u, radius);
+        auto t2 = clock::now();
+
+        if (!degree)
+            for (int q = super::num_qubits; q--;)
+                if (emb.weight(q) >= super::ep.weight_bound) super::total_distance[q] = max_distance;
+
+        update_estimate(base_cost, base_samples, seconds(t1 - t0));
+        if (degree) update_estimate(search_cost, samples[HYBRID_INLINE], seconds(t2 - t1) / degree);
+    }
+
+  protected:
+    //! a drop-in replacement for `compute_distances_from_chain`, which splits the search between threads.  the
+    //! distances come from `sssp`; afterwards, each qubit takes the parent that the serial search would have given it:
+    //! the serial search discovers a qubit from the first of its neighbors to be popped, and nodes are popped in order
+    //! of distance, ties broken by `permutation`.  hence, parents, distances and `visited` match it exactly, and so
+    //! they do out to `radius`: only qubits within it are expanded, and qubits discovered beyond it are at
+    //! `max_distance`.
+    void compute_distances_split(const embedding_t &emb, const int v, vector<int> &visited,
+                                 const distance_t radius = max_distance) {
+        auto &ep = super::ep;
+        auto &parent = super::parents[v];
+        auto &permutation = super::qubit_permutations[v];
+        auto &distance = super::distances[v];
+
+        sources.clear();
+        source_list init{sources};
+        super::dijkstra_initialize_chain(emb, v, parent, visited, init, typename super::default_tag{});
+
+        auto neighbors = [&ep](int q) -> const vector<int> & { return ep.qubit_neighbors(q); };
+        auto relaxable = [&ep, &emb, &visited](int p) { return !visited[p] && emb.weight(p) < ep.weight_bound; };
+        // a qubit is expanded by the search if and only if its distance lies within the radius
+        auto expanded = [this, radius](int p) {
+            distance_t dp = sssp.distance(p);
+            return dp != max_distance && dp <= radius;
+        };
+        auto finish = [&, this](int a, int b) {
+            for (int q = a; q < b; q++) {
+                distance_t d = sssp.distance(q);
+                if (visited[q]) {
+                    // sources were marked by dijkstra_initialize_chain, and masked qubits are left alone
+                    if (d != max_distance) distance[q] = (d <= radius) ? d : max_distance;
+                } else if (emb.weight(q) >= ep.weight_bound) {
+                    // overfull qubits are marked, but not entered, when they're discovered
+                    for (auto &p : ep.qubit_neighbors(q)) {
+                        if (expanded(p)) {
+                            visited[q] = 1;
+                            distance[q] = max_distance;
+                            break;
+                        }
+                    }
+                } else {
+                    // qubits beyond the radius are discovered, but not entered; their distance stays `max_distance`
+                    int z = -1;
+                    distance_t dz = max_distance;
+                    for (auto &p : ep.qubit_neighbors(q)) {
+                        if (!expanded(p)) continue;
+                        distance_t dp = sssp.distance(p);
+                        if (z < 0 || dp < dz || (dp == dz && permutation[p] < permutation[z])) {
+                            z = p;
+                            dz = dp;
+                        }
+                    }
+                    if (z < 0) continue;
+                    parent[q] = z;
+                    distance[q] = d;
+                    visited[q] = 1;
+                }
+            }
+        };
+        sssp.run(neighbors, relaxable, super::qubit_weight, sources, ep.weight(0), finish, radius);
+    }
+
+  private:
+    void prepare_split(const embedding_t &emb, const int u, const int degree) {
+        parallel::prepare_weights(emb, u);
+        for (auto &v : super::ep.var_neighbors(u))
+            if (emb.chainsize(v)) super::prepare_visited(u, v);
+        distance_t radius = super::search_radius(emb, u);
+        for (auto &v : super::ep.var_neighbors(u))
+            if (emb.chainsize(v)) compute_distances_split(emb, v, super::visited_list[v], radius);
+        parallel::neighbors_embedded = degree;
+        parallel::accumulate_all(emb, u);
+    }
+
+  public:
+    pathfinder_hybrid(optional_parameters &p_, int n_v, int n_f, int n_q, int n_r, vector<vector<int>> &v_n,
+                      vector<vector<int>> &q_n)
+            : parallel(p_, n_v, n_f, n_q, n_r, v_n, q_n),
+              base_cost(0),
+              search_cost(0),
+              excess{0, 0, 0},
+              base_samples(0),
+              samples{0, 0, 0},
+              idle{0, 0, 0},
+              sssp(n_q, parallel::num_threads),
+              sources() {}
+    virtual ~pathfinder_hybrid() {}
+
+    virtual void prepare_root_distances(const embedding_t &emb, const int u) override {
+        int degree = 0;
+        for (auto &v : super::ep.var_neighbors(u))
+            if (emb.chainsize(v)) degree++;
+
+        hybrid_mode mode = choose_mode(degree);
+        for (auto &i : idle) i++;
+        idle[mode] = 0;
+
+        if (mode == HYBRID_INLINE) {
+            prepare_inline(emb, u, degree);
+            return;
+        }
+
+        const int T = parallel::num_threads;
+        auto t0 = clock::now();
+        double ideal;
+        if (mode == HYBRID_FANOUT) {
+            parallel::prepare_root_distances(emb, u);
+            ideal = base_cost / T + ((degree + T - 1) / T) * search_cost;
+        } else {
+            prepare_split(emb, u, degree);
+            ideal = (base_cost + degree * search_cost) / T;
+        }
+        update_estimate(excess[mode], samples[mode], seconds(clock::now() - t0) - ideal);
+    }
+};
 }
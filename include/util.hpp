@@ -1,6 +1,8 @@
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <iterator>
 #include <map>
 #include <mutex>
@@ -33,6 +35,12 @@ using std::chrono::duration_cast;
 // Select some default structures and types
 using distance_t = long long int;
 constexpr distance_t max_distance = numeric_limits<distance_t>::max();
+//! distances for problems too large for `distance_t` to hold a useful penalty; see `weight_handler_wide`
+using wide_distance_t = double;
+//! the number of chains holding a qubit.  searches never add a qubit held by `weight_bound` (at most 63) or more
+//! chains, so a byte is plenty, and keeps the fill counts scanned by every search small
+using fill_t = uint8_t;
+constexpr int max_fill_count = numeric_limits<fill_t>::max();
 using RANDOM = fastrng;
 using clock = std::chrono::high_resolution_clock;
 template <typename P>
@@ -40,7 +48,18 @@ using min_queue = std::priority_queue<priority_node<P, min_heap_tag>>;
 template <typename P>
 using max_queue = std::priority_queue<priority_node<P, max_heap_tag>>;
 
-using distance_queue = pairing_queue<priority_node<distance_t, min_heap_tag>>;
+template <typename D>
+using basic_distance_queue = pairing_queue<priority_node<D, min_heap_tag>>;
+using distance_queue = basic_distance_queue<distance_t>;
+
+//! the end of the bucket of width `width` holding the distance `d`, for the bucketed searches; saturates at the
+//! largest distance
+inline distance_t bucket_end(const distance_t d, const distance_t width) {
+    return (d > max_distance - width) ? max_distance : d - d % width + width;
+}
+inline wide_distance_t bucket_end(const wide_distance_t d, const wide_distance_t width) {
+    return std::floor(d / width) * width + width;
+}
 
 //! Interface for communication between the library and various bindings.
 //!
@@ -108,6 +127,33 @@ class CorruptEmbeddingException : public MinorMinerException {
     CorruptEmbeddingException(const string& m = "chains may be invalid") : MinorMinerException(m) {}
 };
 
+class MemoryBudgetException : public MinorMinerException {
+  public:
+    MemoryBudgetException(const string& m = "estimated memory use exceeds memory_budget") : MinorMinerException(m) {}
+};
+
+//! A reusable barrier for a fixed number of threads, by sense reversal.  The phases it separates are short, so
+//! waiting threads spin for a little while before they start yielding.
+class spin_barrier {
+    const int num_threads;
+    std::atomic<int> waiting;
+    std::atomic<int> sense;
+
+  public:
+    spin_barrier(int n) : num_threads(n), waiting(0), sense(0) {}
+
+    void wait() {
+        int my_sense = sense.load(std::memory_order_relaxed);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == num_threads) {
+            waiting.store(0, std::memory_order_relaxed);
+            sense.store(1 - my_sense, std::memory_order_release);
+        } else {
+            for (int spins = 0; sense.load(std::memory_order_acquire) == my_sense;)
+                if (++spins > 64) std::this_thread::yield();
+        }
+    }
+};
+
 //! Set of parameters used to control the embedding process.
 class optional_parameters {
   public:
@@ -124,20 +170,29 @@ class optional_parameters {
     int max_fill = numeric_limits<int>::max();
     bool return_overlap = false;
     int chainlength_patience = 2;
+    //! Maximum number of threads; the outcome for a given seed does not depend on it
     int threads = 1;
+    int placement_window = 0;
+    int order_pool = 0;
+    bool adaptive_schedule = false;
+    //! If nonzero, the number of bytes the pathfinder may allocate, as predicted by `estimate_memory`
+    size_t memory_budget = 0;
+    //! If true, distances are (overlap, length) pairs compared lexicographically, rather than sums of weights
+    //! exponential in the overlap; `max_beta` then has no effect
+    bool lexicographic_weights = false;
     bool skip_initialization = false;
     map<int, vector<int>> fixed_chains;
     map<int, vector<int>> initial_chains;
     map<int, vector<int>> restrict_chains;
 
     //! duplicate all parameters but chain hints,
-    //! and seed a new rng.  this vaguely peculiar behavior is
+    //! and split off a new rng stream.  this vaguely peculiar behavior is
     //! utilized to spawn parameters for component subproblems
     optional_parameters(optional_parameters& p, map<int, vector<int>> fixed_chains,
                         map<int, vector<int>> initial_chains, map<int, vector<int>> restrict_chains)
             : localInteractionPtr(p.localInteractionPtr),
               max_no_improvement(p.max_no_improvement),
-              rng(p.rng()),
+              rng(p.rng.split()),
               timeout(p.timeout),
               max_beta(p.max_beta),
               tries(p.tries),
@@ -147,6 +202,11 @@ class optional_parameters {
               return_overlap(p.return_overlap),
               chainlength_patience(p.chainlength_patience),
               threads(p.threads),
+              placement_window(p.placement_window),
+              order_pool(p.order_pool),
+              adaptive_schedule(p.adaptive_schedule),
+              memory_budget(p.memory_budget),
+              lexicographic_weights(p.lexicographic_weights),
               skip_initialization(p.skip_initialization),
               fixed_chains(fixed_chains),
               initial_chains(initial_chains),
@@ -209,4 +269,22 @@ void collectMinima(const vector<T>& input, vector<int>& output) {
         index++;
     }
 }
+
+//! Fill output with those of the `indices` at which `input` takes its least value among them, in the order given
+template <typename T>
+void collectMinima(const vector<T>& input, const vector<int>& indices, vector<int>& output) {
+    output.clear();
+    if (indices.empty()) return;
+    auto lowest_value = input[indices[0]];
+    for (auto& i : indices) {
+        auto& y = input[i];
+        if (y == lowest_value) {
+            output.push_back(i);
+        } else if (y < lowest_value) {
+            output.clear();
+            output.push_back(i);
+            lowest_value = y;
+        }
+    }
+}
 }
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <vector>
+#include "graph.hpp"
+#include "util.hpp"
+
+namespace find_embedding {
+
+//! the kinds of fault found by `verify_embedding`
+enum VERIFY {
+    VERIFY_OK,
+    VERIFY_MISSING_CHAIN,
+    VERIFY_BAD_QUBIT,
+    VERIFY_OVERLAP,
+    VERIFY_BROKEN_CHAIN,
+    VERIFY_MISSING_EDGE
+};
+
+//! The outcome of `verify_embedding`.  For a missing or broken chain, `u` is the variable; for a qubit that isn't in
+//! the target, `u` is the variable and `q` the qubit; for an overlap, `u` and `v` are two variables whose chains share
+//! the qubit `q`; and for a missing edge, `u` and `v` are the ends of the source edge.  Unused fields are -1.
+struct verify_result {
+    VERIFY status;
+    int u, v, q;
+
+    verify_result(VERIFY s = VERIFY_OK, int u_ = -1, int v_ = -1, int q_ = -1) : status(s), u(u_), v(v_), q(q_) {}
+    explicit operator bool() const { return status == VERIFY_OK; }
+};
+
+//! Checks that `chains` is an embedding of `var_g` into `qubit_g`, in the labels of the input graphs (as returned by
+//! findEmbedding): that every variable has a nonempty chain of qubits in the target, that the chains are disjoint and
+//! connected, and that every source edge is carried by a target edge between the chains of its ends.  Chains may be
+//! given for variables beyond the nodes of `var_g`, which are checked as isolated variables.  Self-loops are ignored in
+//! both graphs, as they are by findEmbedding.
+//!
+//! This runs in time linear in the sizes of both graphs and the chains, without the O(V x Q) tables of
+//! `embedding::run_long_diagnostic`, and is available in release builds.  Disjointness is checked first, serially;
+//! the checks of connectivity and edge coverage then split the variables between `threads` threads.  Each variable's
+//! chain is walked once, marking the owners of the qubits next to it, so each target edge is read twice in all.  When
+//! several faults are present, the one reported is the same for any number of threads.
+inline verify_result verify_embedding(const graph::input_graph &var_g, const graph::input_graph &qubit_g,
+                                      const vector<vector<int>> &chains, int threads = 1) {
+    const int num_v = max(var_g.num_nodes(), static_cast<int>(chains.size()));
+    const int num_q = qubit_g.num_nodes();
+
+    // the owner of each qubit; this settles disjointness, and is the index used by every later check
+    vector<int> owner(num_q, -1);
+    for (int u = 0; u < num_v; u++) {
+        if (u >= static_cast<int>(chains.size()) || chains[u].empty()) return verify_result(VERIFY_MISSING_CHAIN, u);
+        for (auto &q : chains[u]) {
+            if (q < 0 || q >= num_q) return verify_result(VERIFY_BAD_QUBIT, u, -1, q);
+            if (owner[q] != -1) return verify_result(VERIFY_OVERLAP, owner[q], u, q);
+            owner[q] = u;
+        }
+    }
+
+    // both graphs as compressed adjacency lists, without self-loops; parallel edges are harmless
+    auto adjacency = [](const graph::input_graph &g, int n, vector<int> &offset, vector<int> &nbrs) {
+        offset.assign(n + 1, 0);
+        for (int i = g.num_edges(); i--;)
+            if (g.a(i) != g.b(i)) {
+                offset[g.a(i) + 1]++;
+                offset[g.b(i) + 1]++;
+            }
+        for (int x = 0; x < n; x++) offset[x + 1] += offset[x];
+        nbrs.resize(offset[n]);
+        vector<int> fill(offset.begin(), offset.end() - 1);
+        for (int i = g.num_edges(); i--;)
+            if (g.a(i) != g.b(i)) {
+                nbrs[fill[g.a(i)]++] = g.b(i);
+                nbrs[fill[g.b(i)]++] = g.a(i);
+            }
+    };
+    vector<int> var_offset, var_nbrs, qubit_offset, qubit_nbrs;
+    adjacency(var_g, num_v, var_offset, var_nbrs);
+    adjacency(qubit_g, num_q, qubit_offset, qubit_nbrs);
+
+    // each qubit belongs to one chain, so the threads never touch the same entries of `visited`
+    vector<uint8_t> visited(num_q, 0);
+
+    // checks the variables in [a, b), returning the first fault
+    auto check_range = [&](int a, int b) {
+        // the last variable for which each variable was seen next to a chain
+        vector<int> seen(num_v, -1);
+        vector<int> queue;
+        for (int u = a; u < b; u++) {
+            auto &chain = chains[u];
+            queue.assign(1, chain[0]);
+            visited[chain[0]] = 1;
+            for (size_t i = 0; i < queue.size(); i++) {
+                int p = queue[i];
+                for (int j = qubit_offset[p]; j < qubit_offset[p + 1]; j++) {
+                    int q = qubit_nbrs[j], v = owner[q];
+                    if (v == u) {
+                        if (!visited[q]) {
+                            visited[q] = 1;
+                            queue.push_back(q);
+                        }
+                    } else if (v != -1) {
+                        seen[v] = u;
+                    }
+                }
+            }
+            if (queue.size() != chain.size()) return verify_result(VERIFY_BROKEN_CHAIN, u);
+            for (int j = var_offset[u]; j < var_offset[u + 1]; j++)
+                if (seen[var_nbrs[j]] != u) return verify_result(VERIFY_MISSING_EDGE, u, var_nbrs[j]);
+        }
+        return verify_result();
+    };
+
+    threads = max(1, min(threads, num_v));
+    if (threads == 1) return check_range(0, num_v);
+
+    vector<std::future<verify_result>> futures(threads);
+    const int grainsize = num_v / threads;
+    int grainmod = num_v % threads;
+    int a = 0;
+    for (int i = 0; i < threads; i++) {
+        int b = a + grainsize + (grainmod-- > 0);
+        futures[i] = std::async(std::launch::async, check_range, a, b);
+        a = b;
+    }
+    verify_result result;
+    for (auto &f : futures) {
+        verify_result r = f.get();
+        if (result && !r) result = r;
+    }
+    return result;
+}
+}
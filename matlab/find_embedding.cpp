@@ -130,6 +130,11 @@ void checkFindEmbeddingParameters(const mxArray* paramsArray,
     paramsNameSet.insert("initial_chains");
     paramsNameSet.insert("restrict_chains");
     paramsNameSet.insert("threads");
+    paramsNameSet.insert("placement_window");
+    paramsNameSet.insert("order_pool");
+    paramsNameSet.insert("adaptive_schedule");
+    paramsNameSet.insert("memory_budget");
+    paramsNameSet.insert("lexicographic_weights");
 
     int numFields = mxGetNumberOfFields(paramsArray);
     for (int i = 0; i < numFields; ++i) {
@@ -187,6 +192,31 @@ void checkFindEmbeddingParameters(const mxArray* paramsArray,
         parseScalar<int>(fieldValueArray, "threads parameter must be an integer >= 0",
                          findEmbeddingExternalParams.threads);
 
+    fieldValueArray = mxGetField(paramsArray, 0, "placement_window");
+    if (fieldValueArray)
+        parseScalar<int>(fieldValueArray, "placement_window parameter must be an integer >= 0",
+                         findEmbeddingExternalParams.placement_window);
+
+    fieldValueArray = mxGetField(paramsArray, 0, "order_pool");
+    if (fieldValueArray)
+        parseScalar<int>(fieldValueArray, "order_pool parameter must be an integer >= 0",
+                         findEmbeddingExternalParams.order_pool);
+
+    fieldValueArray = mxGetField(paramsArray, 0, "adaptive_schedule");
+    if (fieldValueArray)
+        parseBoolean(fieldValueArray, "adaptive_schedule must be a boolean value",
+                     findEmbeddingExternalParams.adaptive_schedule);
+
+    fieldValueArray = mxGetField(paramsArray, 0, "memory_budget");
+    if (fieldValueArray)
+        parseScalar<size_t>(fieldValueArray, "memory_budget parameter must be an integer >= 0",
+                            findEmbeddingExternalParams.memory_budget);
+
+    fieldValueArray = mxGetField(paramsArray, 0, "lexicographic_weights");
+    if (fieldValueArray)
+        parseBoolean(fieldValueArray, "lexicographic_weights must be a boolean value",
+                     findEmbeddingExternalParams.lexicographic_weights);
+
     fieldValueArray = mxGetField(paramsArray, 0, "chainlength_patience");
     if (fieldValueArray)
         parseScalar<int>(fieldValueArray, "chainlength_patience parameter must be an integer >= 0",
@@ -62,11 +62,45 @@
 %             of variables whose chain may contain a given qubit.
 %             (must be an integer >= 0, default = effectively infinite)
 %
-%   threads: maximum number of threads to use.  note that the parallelization is only
-%            advantageous where the expected degree of variables is (significantly?)
-%            greater than the number of threads.
+%   threads: maximum number of threads to use.  threads are only used for a chain
+%            placement when earlier placements indicate that they will pay off,
+%            typically when the variable's degree is large compared to the number
+%            of threads.  with a given random_seed, the embedding found does
+%            not depend on the number of threads (barring timeouts).
 %            (must be an integer >= 1, default = 1)
 %
+%   placement_window: when positive, each chain placed after the initialization pass
+%                     is sought among the qubits within this many hops of the
+%                     variable's old chain and the chains of its neighbors; the whole
+%                     target is searched if no root is found there.
+%                     (must be an integer >= 0, default = 0, which searches the whole target)
+%
+%   order_pool: when positive, the variable orderings used by each pass are drawn from
+%               a pool of this many orderings, built once and served in turn with a
+%               few random swaps each time, rather than built anew for every pass.
+%               (must be an integer >= 0, default = 0, which builds a new ordering
+%               for every pass)
+%
+%   adaptive_schedule: instead of counting passes against tries, max_no_improvement
+%                      and inner_rounds, measure how quickly each kind of overfill pass
+%                      reduces overlap and run whichever is most productive, restarting
+%                      from the initial chains when progress stalls.  the search runs
+%                      until an embedding is found or the timeout is reached, and
+%                      results depend on timings.
+%                      (must be a boolean, default = false)
+%
+%   memory_budget: when positive, an upper bound in bytes on the memory used by the
+%                  search, as estimated before anything is allocated.  restricted
+%                  chains are stored in a more compact (and slower) form when that
+%                  fits; otherwise an error is raised instead of running out of memory.
+%                  (must be an integer >= 0, default = 0, which sets no bound)
+%
+%   lexicographic_weights: compare paths first by the overlap of the qubits they
+%                          pass through, and then by their length, rather than by
+%                          a sum of weights exponential in the overlap.  max_beta
+%                          has no effect when this is set.
+%                          (must be a boolean, default = false)
+%
 %   return_overlap: return an embedding whether or not qubits are used by multiple
 %                   variables -- capture both return values to determine whether or
 %                   not the returned embedding is valid
@@ -1,4 +1,4 @@
-from minorminer_c import miner, VARORDER, find_embedding as __find_embedding
+from minorminer_c import miner, VARORDER, verify_embedding, EmbeddingError, find_embedding as __find_embedding
 from functools import wraps as __wraps
 
 # This wrapper exists to overcome a curious limitation of Cython, and make
@@ -14,6 +14,11 @@ def find_embedding(S, T,
                    chainlength_patience=10,
                    max_fill=None,
                    threads=1,
+                   placement_window=0,
+                   order_pool=0,
+                   adaptive_schedule=False,
+                   memory_budget=0,
+                   lexicographic_weights=False,
                    return_overlap=False,
                    skip_initialization=False,
                    verbose=0,
@@ -32,6 +37,11 @@ def find_embedding(S, T,
                             chainlength_patience=chainlength_patience,
                             max_fill=max_fill,
                             threads=threads,
+                            placement_window=placement_window,
+                            order_pool=order_pool,
+                            adaptive_schedule=adaptive_schedule,
+                            memory_budget=memory_budget,
+                            lexicographic_weights=lexicographic_weights,
                             return_overlap=return_overlap,
                             skip_initialization=skip_initialization,
                             verbose=verbose,
@@ -102,10 +102,51 @@ def find_embedding(S, T, **params):
             incorporate the same qubit during the search. Integer >= 0, values
             above 63 are treated as 63 (default = effectively infinite)
 
-        threads: Maximum number of threads to use. Note that the
-            parallelization is only advantageous where the expected degree of
-            variables is significantly greater than the number of threads.
-            Integer >= 1 (default = 1)
+        threads: Maximum number of threads to use. Threads are only used
+            for a chain placement when earlier placements indicate they will
+            pay off, which is typical when the variable's degree is large
+            compared to the number of threads.  With a given random_seed,
+            the embedding found does not depend on the number of threads
+            (barring timeouts). Integer >= 1 (default = 1)
+
+        placement_window: When positive, each chain placed after the
+            initialization pass is sought among the qubits within this many
+            hops of the variable's old chain and the chains of its neighbors,
+            which is much cheaper than searching the whole target graph when
+            the target is large.  If no root is found there, the whole target
+            is searched; in the chainlength phase, the old chain is kept
+            instead, unless a shorter one is found in the window.
+            Integer >= 0 (default = 0, which searches the whole target)
+
+        order_pool: When positive, the variable orderings used by each pass
+            are drawn from a pool of this many orderings, built once (in
+            parallel, if threads > 1) and served in turn with a few random
+            swaps each time, rather than being built anew for every pass.
+            Integer >= 0 (default = 0, which builds a new ordering for every
+            pass)
+
+        adaptive_schedule: Instead of counting passes against tries,
+            max_no_improvement and inner_rounds, measure how quickly each
+            kind of overfill pass reduces overlap and run whichever is most
+            productive, restarting from the initial chains when progress
+            stalls.  The search for an embedding then runs until one is found
+            or the timeout is reached, and results depend on timings.
+            Boolean (default = False)
+
+        memory_budget: When positive, an upper bound in bytes on the memory
+            used by the search, as estimated before anything is allocated.
+            If chains are restricted, the restrictions are stored in a more
+            compact (and slower) form when that fits in the budget; otherwise
+            a RuntimeError is raised rather than running out of memory.
+            Integer >= 0 (default = 0, which sets no bound)
+
+        lexicographic_weights: Compare paths first by the overlap of the
+            qubits they pass through, and then by their length, rather than by
+            a sum of weights exponential in the overlap.  A path through any
+            number of free qubits is preferred over one through a used qubit.
+            max_beta has no effect when this is set.  Problems too large for
+            these weights fall back on the floating point ones.
+            Boolean (default = False)
 
         return_overlap: This function returns an embedding whether or not qubits
             are used by multiple variables. Set this value to 1 to capture both
@@ -216,6 +257,68 @@ def find_embedding(S, T, **params):
 class EmptySourceGraphError(RuntimeError):
     pass
 
+class EmbeddingError(ValueError):
+    pass
+
+def verify_embedding(emb, S, T, threads=1):
+    """
+    verify_embedding(emb, S, T, threads=1)
+    Check that emb is an embedding of S into T, much faster than it can be
+    done with NetworkX.
+
+    Args::
+
+        emb: a dict that maps labels in S to lists of labels in T, as
+            returned by find_embedding
+
+        S: an iterable of label pairs representing the edges in the source graph, or a NetworkX Graph
+
+        T: an iterable of label pairs representing the edges in the target graph, or a NetworkX Graph
+
+        threads: the number of threads used to check the chains; the time
+            taken is linear in the sizes of S, T and emb either way.
+            Integer (default = 1)
+
+    Returns::
+
+        True, when every node of S has a chain, the chains are connected and
+        disjoint, and every edge of S is carried by an edge of T between the
+        chains of its ends.  Otherwise, raises an EmbeddingError describing
+        the first problem found.
+    """
+    cdef input_graph Sg, Tg
+    cdef labeldict SL = _read_graph(Sg, S)
+    cdef labeldict TL = _read_graph(Tg, T)
+    _read_nodes(Sg, SL, S)
+    _read_nodes(Tg, TL, T)
+
+    cdef vector[vector[int]] chains
+    chains.resize(len(SL))
+    for x in emb:
+        if x not in SL:
+            raise EmbeddingError("chain for nonexistent variable %s" % (x,))
+        for q in emb[x]:
+            if q not in TL:
+                raise EmbeddingError("chain for %s includes nonexistent qubit %s" % (x, q))
+            chains[SL[x]].push_back(TL[q])
+
+    cdef int nthreads = threads
+    cdef verify_result r
+    with nogil:
+        r = _verify_embedding(Sg, Tg, chains, nthreads)
+
+    if r.status == VERIFY_MISSING_CHAIN:
+        raise EmbeddingError("missing chain for %s" % (SL.label(r.u),))
+    elif r.status == VERIFY_OVERLAP:
+        raise EmbeddingError("chains for %s and %s overlap at %s" % (SL.label(r.u), SL.label(r.v), TL.label(r.q)))
+    elif r.status == VERIFY_BROKEN_CHAIN:
+        raise EmbeddingError("broken chain for %s" % (SL.label(r.u),))
+    elif r.status == VERIFY_MISSING_EDGE:
+        raise EmbeddingError("missing edge between %s and %s" % (SL.label(r.u), SL.label(r.v)))
+    elif r.status != VERIFY_OK:
+        raise EmbeddingError("chain for %s is not in the target" % (SL.label(r.u),))
+    return True
+
 cdef class _input_parser:
     cdef input_graph Sg, Tg
     cdef labeldict SL, TL
@@ -230,7 +333,9 @@ cdef class _input_parser:
         names = {"max_no_improvement", "random_seed", "timeout", "tries", "verbose",
                  "fixed_chains", "initial_chains", "max_fill", "chainlength_patience",
                  "return_overlap", "skip_initialization", "inner_rounds", "threads",
-                 "restrict_chains", "suspend_chains", "max_beta"}
+                 "restrict_chains", "suspend_chains", "max_beta", "placement_window",
+                 "order_pool", "adaptive_schedule", "memory_budget",
+                 "lexicographic_weights"}
 
         for name in params:
             if name not in names:
@@ -288,6 +393,26 @@ cdef class _input_parser:
         if z is not None:
             self.opts.threads = int(z)
 
+        z = params.get("placement_window")
+        if z is not None:
+            self.opts.placement_window = int(z)
+
+        z = params.get("order_pool")
+        if z is not None:
+            self.opts.order_pool = int(z)
+
+        z = params.get("adaptive_schedule")
+        if z is not None:
+            self.opts.adaptive_schedule = int(z)
+
+        z = params.get("memory_budget")
+        if z is not None:
+            self.opts.memory_budget = int(z)
+
+        z = params.get("lexicographic_weights")
+        if z is not None:
+            self.opts.lexicographic_weights = int(z)
+
         self.SL = _read_graph(self.Sg, S)
         if not self.SL:
             raise EmptySourceGraphError
@@ -603,4 +728,13 @@ cdef _read_graph(input_graph &g, E):
         g.push_back(L[a],L[b])
     return L
 
-__all__ = ["find_embedding", "VARORDER", "miner"]
+cdef _read_nodes(input_graph &g, labeldict L, G):
+    # isolated nodes are added as self-loops, which the library ignores
+    cdef int k
+    if hasattr(G, 'nodes'):
+        for x in G.nodes():
+            if x not in L:
+                k = L[x]
+                g.push_back(k, k)
+
+__all__ = ["find_embedding", "verify_embedding", "EmbeddingError", "VARORDER", "miner"]
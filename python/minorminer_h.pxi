@@ -124,12 +124,35 @@ cdef extern from "../include/util.hpp" namespace "find_embedding":
         chainmap initial_chains
         chainmap restrict_chains
         int threads
+        int placement_window
+        int order_pool
+        bint adaptive_schedule
+        size_t memory_budget
+        bint lexicographic_weights
 
 
 cdef extern from "../include/find_embedding.hpp" namespace "find_embedding":
     int findEmbedding(input_graph, input_graph, optional_parameters, vector[vector[int]]&) except +
 
 
+cdef extern from "../include/verify.hpp" namespace "find_embedding":
+    cdef enum VERIFY:
+        VERIFY_OK
+        VERIFY_MISSING_CHAIN
+        VERIFY_BAD_QUBIT
+        VERIFY_OVERLAP
+        VERIFY_BROKEN_CHAIN
+        VERIFY_MISSING_EDGE
+
+    cppclass verify_result:
+        verify_result()
+        VERIFY status
+        int u, v, q
+
+    verify_result _verify_embedding "find_embedding::verify_embedding"(input_graph &, input_graph &,
+                                                                      vector[vector[int]] &, int) nogil
+
+
 cdef extern from "minorminer.pyx.hpp" namespace "":
     cppclass LocalInteractionPython(LocalInteraction):
         LocalInteractionPython()
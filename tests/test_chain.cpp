@@ -5,7 +5,7 @@
 using std::vector;
 
 struct embedding {
-    std::vector<int> qubit_weights;
+    std::vector<find_embedding::fill_t> qubit_weights;
     std::vector<find_embedding::chain> var_embedding;
     embedding(int num_qubits, int num_vars) : qubit_weights(num_qubits, 0) {
         for (int v = 0; v < num_vars; v++) var_embedding.emplace_back(qubit_weights, v);
@@ -20,7 +20,7 @@ class embedding_problem_t {
 //
 TEST(chain, construction_empty) {
     std::mt19937_64 rng(0);
-    std::vector<int> weight(5, 0);
+    std::vector<find_embedding::fill_t> weight(5, 0);
     find_embedding::chain c(weight, 0);
     ASSERT_EQ(c.run_diagnostic(), 0);
     ASSERT_EQ(c.get_link(0), -1);
@@ -28,7 +28,7 @@ TEST(chain, construction_empty) {
 
 TEST(chain, construction_root) {
     std::mt19937_64 rng(0);
-    std::vector<int> weight(5, 0);
+    std::vector<find_embedding::fill_t> weight(5, 0);
     find_embedding::chain c(weight, 0);
     c.set_root(0);
     ASSERT_EQ(c.run_diagnostic(), 0);
@@ -37,7 +37,7 @@ TEST(chain, construction_root) {
 
 TEST(chain, trim_root_bounce) {
     std::mt19937_64 rng(0);
-    std::vector<int> weight(5, 0);
+    std::vector<find_embedding::fill_t> weight(5, 0);
     find_embedding::chain c(weight, 0);
     c.set_root(0);
     c.trim_leaf(0);
@@ -47,7 +47,7 @@ TEST(chain, trim_root_bounce) {
 
 TEST(chain, trim_root_branch_bounce) {
     std::mt19937_64 rng(0);
-    std::vector<int> weight(5, 0);
+    std::vector<find_embedding::fill_t> weight(5, 0);
     find_embedding::chain c(weight, 0);
     c.set_root(0);
     c.trim_branch(0);
@@ -57,7 +57,7 @@ TEST(chain, trim_root_branch_bounce) {
 
 TEST(chain, add_leaves_path) {
     std::mt19937_64 rng(0);
-    std::vector<int> weight(5, 0);
+    std::vector<find_embedding::fill_t> weight(5, 0);
     find_embedding::chain c(weight, 0);
     c.set_root(0);
     c.add_leaf(1, 0);
@@ -76,7 +76,7 @@ TEST(chain, add_leaves_path) {
 
 TEST(chain, trim_branch) {
     std::mt19937_64 rng(0);
-    std::vector<int> weight(5, 0);
+    std::vector<find_embedding::fill_t> weight(5, 0);
     find_embedding::chain c(weight, 0);
     c.set_root(0);
     c.add_leaf(1, 0);
@@ -92,7 +92,7 @@ TEST(chain, trim_branch) {
 
 TEST(chain, linkpath) {
     std::mt19937_64 rng(0);
-    std::vector<int> weight(50, 0);
+    std::vector<find_embedding::fill_t> weight(50, 0);
     find_embedding::chain c(weight, 0);
     find_embedding::chain d(weight, 1);
     find_embedding::chain e(weight, 2);
@@ -121,7 +121,7 @@ TEST(chain, linkpath) {
 
 TEST(chain, linkpath_overlap) {
     std::mt19937_64 rng(0);
-    std::vector<int> weight(1, 0);
+    std::vector<find_embedding::fill_t> weight(1, 0);
     find_embedding::chain c(weight, 0);
     find_embedding::chain d(weight, 1);
     std::vector<int> parents(1, 0);
@@ -135,7 +135,7 @@ TEST(chain, linkpath_overlap) {
 TEST(chain, linkpathandsteal) {
     embedding_problem_t mock;
     std::mt19937_64 rng(0);
-    std::vector<int> weight(50, 0);
+    std::vector<find_embedding::fill_t> weight(50, 0);
     find_embedding::chain c(weight, 0);
     find_embedding::chain d(weight, 1);
     find_embedding::chain e(weight, 2);
@@ -179,7 +179,7 @@ TEST(chain, linkpathandsteal) {
 TEST(chain, balancechains) {
     embedding_problem_t mock;
     std::mt19937_64 rng(0);
-    std::vector<int> weight(50, 0);
+    std::vector<find_embedding::fill_t> weight(50, 0);
     find_embedding::chain c(weight, 0);
     find_embedding::chain d(weight, 1);
     std::vector<int> parents(50, -1);
@@ -198,7 +198,7 @@ TEST(chain, balancechains) {
 }
 
 TEST(chain, adoption) {
-    std::vector<int> weight(50, 0);
+    std::vector<find_embedding::fill_t> weight(50, 0);
     find_embedding::chain c(weight, 0);
     c = vector<int>{0, 1, 2};
     c.adopt(0, 1);
@@ -213,7 +213,7 @@ TEST(chain, adoption) {
 }
 
 TEST(chain, copying) {
-    std::vector<int> weight(50, 0);
+    std::vector<find_embedding::fill_t> weight(50, 0);
     find_embedding::chain d(weight, 0);
     d = vector<int>{0, 1, 2};
     d.adopt(0, 1);
@@ -230,10 +230,10 @@ TEST(chain, copying) {
 }
 
 TEST(chain, clear) {
-    std::vector<int> dweight(3, 0);
-    std::vector<int> cweight(3, 0);
-    std::vector<int> zero(3, 0);
-    std::vector<int> one(3, 1);
+    std::vector<find_embedding::fill_t> dweight(3, 0);
+    std::vector<find_embedding::fill_t> cweight(3, 0);
+    std::vector<find_embedding::fill_t> zero(3, 0);
+    std::vector<find_embedding::fill_t> one(3, 1);
     find_embedding::chain d(dweight, 0);
     find_embedding::chain c(cweight, 0);
     d = std::vector<int>{0, 1, 2};
@@ -253,7 +253,7 @@ TEST(chain, clear) {
 TEST(chain, steal_gc) {
     embedding_problem_t mock;
     std::mt19937_64 rng(0);
-    std::vector<int> weight(50, 0);
+    std::vector<find_embedding::fill_t> weight(50, 0);
     find_embedding::chain c(weight, 0);
     find_embedding::chain d(weight, 1);
     find_embedding::chain e(weight, 2);
@@ -0,0 +1,192 @@
+#include <map>
+#include <queue>
+#include <random>
+#include <vector>
+#include "delta_stepping.hpp"
+#include "gtest/gtest.h"
+#include "pathfinder.hpp"
+using find_embedding::delta_stepping;
+using find_embedding::distance_t;
+using find_embedding::max_distance;
+using std::map;
+using std::vector;
+
+// a plain node-weighted dijkstra with the same conventions as delta_stepping::run
+static vector<distance_t> reference_distances(const vector<vector<int>> &nbrs, const vector<int> &relaxable,
+                                              const vector<distance_t> &weight,
+                                              const vector<delta_stepping::entry> &sources) {
+    vector<distance_t> dist(nbrs.size(), max_distance);
+    std::priority_queue<std::pair<distance_t, int>, vector<std::pair<distance_t, int>>,
+                        std::greater<std::pair<distance_t, int>>>
+            pq;
+    for (auto &s : sources)
+        if (s.second < dist[s.first]) pq.emplace(dist[s.first] = s.second, s.first);
+    while (!pq.empty()) {
+        auto z = pq.top();
+        pq.pop();
+        if (z.first != dist[z.second]) continue;
+        for (auto &p : nbrs[z.second]) {
+            if (relaxable[p] && z.first + weight[p] < dist[p]) pq.emplace(dist[p] = z.first + weight[p], p);
+        }
+    }
+    return dist;
+}
+
+TEST(delta_stepping, matches_dijkstra) {
+    const int n = 300;
+    std::mt19937 rng(17);
+    for (int trial = 0; trial < 12; trial++) {
+        vector<vector<int>> nbrs(n);
+        for (int i = 0; i < 3 * n; i++) {
+            int a = rng() % n, b = rng() % n;
+            if (a == b) continue;
+            nbrs[a].push_back(b);
+            nbrs[b].push_back(a);
+        }
+        vector<distance_t> weight(n);
+        vector<int> relaxable(n);
+        for (int q = 0; q < n; q++) {
+            weight[q] = (trial % 2) ? 1 + rng() % 3 : distance_t(1) << (rng() % 5);
+            relaxable[q] = (rng() % 8) != 0;
+        }
+        vector<delta_stepping::entry> sources;
+        for (int i = 0; i < 3; i++) {
+            int q = rng() % n;
+            relaxable[q] = 0;
+            sources.emplace_back(q, (trial % 3) ? 0 : weight[q]);
+        }
+        auto expected = reference_distances(nbrs, relaxable, weight, sources);
+
+        for (int threads = 1; threads <= 4; threads++) {
+            for (distance_t delta : {1, 2, 7}) {
+                delta_stepping sssp(n, threads);
+                vector<int> covered(n, 0);
+                sssp.run([&nbrs](int q) -> const vector<int> & { return nbrs[q]; },
+                         [&relaxable](int p) { return relaxable[p] != 0; }, weight, sources, delta,
+                         [&covered](int a, int b) {
+                             for (int q = a; q < b; q++) covered[q]++;
+                         });
+                for (int q = 0; q < n; q++) {
+                    ASSERT_EQ(sssp.distance(q), expected[q]);
+                    ASSERT_EQ(covered[q], 1);
+                }
+            }
+        }
+    }
+}
+
+namespace {
+template <typename embedding_problem_t>
+class split_probe : public find_embedding::pathfinder_hybrid<embedding_problem_t> {
+    using super = find_embedding::pathfinder_base<embedding_problem_t>;
+    using hybrid = find_embedding::pathfinder_hybrid<embedding_problem_t>;
+
+  public:
+    using embedding_t = typename hybrid::embedding_t;
+
+    split_probe(find_embedding::optional_parameters &p, int n_v, int n_f, int n_q, int n_r, vector<vector<int>> &v_n,
+                vector<vector<int>> &q_n)
+            : hybrid(p, n_v, n_f, n_q, n_r, v_n, q_n) {}
+
+    embedding_problem_t &problem() { return super::ep; }
+
+    //! runs the serial search (`split = false`) or the split search from the chain of `v` out to `radius`, starting
+    //! from the mask `mask`, on parents and distances filled with junk
+    void search(const embedding_t &emb, int v, const vector<int> &mask, bool split, distance_t radius,
+                vector<int> &parent, vector<distance_t> &distance, vector<int> &visited) {
+        super::compute_qubit_weights(emb);
+        std::fill(super::parents[v].begin(), super::parents[v].end(), -2);
+        std::fill(super::distances[v].begin(), super::distances[v].end(), 7);
+        visited = mask;
+        if (split)
+            hybrid::compute_distances_split(emb, v, visited, radius);
+        else
+            super::compute_distances_from_chain(emb, v, visited, radius);
+        parent = super::parents[v];
+        distance = super::distances[v];
+    }
+
+    void shuffle_permutation(int v) {
+        auto &permutation = super::qubit_permutations[v];
+        super::ep.shuffle(permutation.begin(), permutation.end());
+    }
+};
+}
+
+// the split search is a drop-in replacement for the serial one: from an unfixed or a fixed chain, through masked and
+// overfull qubits, with ties broken by a shuffled permutation, and with or without a radius, it leaves the same
+// parents, distances and visited marks
+TEST(delta_stepping, split_matches_serial) {
+    using namespace find_embedding;
+    typedef embedding_problem<fixed_handler_hival, domain_handler_universe, output_handler_error> problem_t;
+    // a 4x4 chimera graph, with qubit k of shore s of the cell in row i and column j labeled ((4i + j)2 + s)4 + k
+    const int m = 4, n_v = 12, n_f = 1, n_q = 8 * m * m, n_r = 1;
+    vector<vector<int>> qubit_nbrs(n_q + n_r), var_nbrs(n_v + n_f);
+    auto label = [m](int i, int j, int s, int k) { return ((i * m + j) * 2 + s) * 4 + k; };
+    auto couple = [&qubit_nbrs](int p, int q) {
+        qubit_nbrs[p].push_back(q);
+        qubit_nbrs[q].push_back(p);
+    };
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < m; j++)
+            for (int k = 0; k < 4; k++) {
+                for (int l = 0; l < 4; l++) couple(label(i, j, 0, k), label(i, j, 1, l));
+                if (i + 1 < m) couple(label(i, j, 0, k), label(i + 1, j, 0, k));
+                if (j + 1 < m) couple(label(i, j, 1, k), label(i, j + 1, 1, k));
+            }
+    // the reserved qubit of the fixed variable reaches into three cells
+    for (int q : {0, 4, 40, 44, 80, 84}) qubit_nbrs[n_q].push_back(q);
+    for (int u = 0; u < n_v; u++) {
+        var_nbrs[u].push_back((u + 1) % n_v);
+        var_nbrs[(u + 1) % n_v].push_back(u);
+    }
+    var_nbrs[0].push_back(n_v);
+
+    optional_parameters params;
+    params.threads = 4;
+    params.max_fill = 2;
+    params.seed(5);
+    split_probe<problem_t> pf(params, n_v, n_f, n_q, n_r, var_nbrs, qubit_nbrs);
+
+    std::mt19937 rng(23);
+    for (int trial = 0; trial < 8; trial++) {
+        // random walks for chains, which overlap here and there; with a `max_fill` of 2, the shared qubits are full
+        map<int, vector<int>> fixed, initial;
+        fixed[n_v] = {n_q};
+        for (int u = 0; u < n_v; u++) {
+            int q = rng() % n_q;
+            for (int i = 0; i < 10; i++) {
+                if (std::find(initial[u].begin(), initial[u].end(), q) == initial[u].end()) initial[u].push_back(q);
+                q = qubit_nbrs[q][rng() % qubit_nbrs[q].size()];
+            }
+        }
+        embedding<problem_t> emb(pf.problem(), fixed, initial);
+        int overfull = 0;
+        for (int q = 0; q < n_q; q++) overfull += emb.weight(q) >= pf.problem().weight_bound;
+        ASSERT_GT(overfull, 0);
+
+        vector<int> mask(n_q, 0);
+        for (int q = 0; q < n_q; q++)
+            if (rng() % 6 == 0) mask[q] = -1;
+
+        for (int v : {0, 5, n_v}) {
+            pf.shuffle_permutation(v);
+            // the second radius is the distance of a random qubit reached by the unbounded search
+            distance_t radius = max_distance;
+            for (int pass = 0; pass < 2; pass++) {
+                vector<int> serial_parent, split_parent, serial_visited, split_visited;
+                vector<distance_t> serial_distance, split_distance;
+                pf.search(emb, v, mask, false, radius, serial_parent, serial_distance, serial_visited);
+                pf.search(emb, v, mask, true, radius, split_parent, split_distance, split_visited);
+                for (int q = 0; q < n_q + n_r; q++) {
+                    ASSERT_EQ(serial_parent[q], split_parent[q]) << "trial " << trial << " v " << v << " q " << q;
+                    ASSERT_EQ(serial_distance[q], split_distance[q]) << "trial " << trial << " v " << v << " q " << q;
+                }
+                for (int q = 0; q < n_q; q++)
+                    ASSERT_EQ(serial_visited[q], split_visited[q]) << "trial " << trial << " v " << v << " q " << q;
+                do radius = serial_distance[rng() % n_q];
+                while (radius == max_distance);
+            }
+        }
+    }
+}
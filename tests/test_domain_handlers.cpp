@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "embedding_problem.hpp"
+#include "gtest/gtest.h"
+using find_embedding::distance_t;
+using std::vector;
+
+// builds restrictions for every other variable: a few runs of consecutive qubits, plus scattered singletons
+static find_embedding::optional_parameters random_restrictions(int n_v, int n_q, unsigned seed) {
+    find_embedding::optional_parameters params;
+    std::mt19937 rng(seed);
+    for (int v = 0; v < n_v; v += 2) {
+        vector<int> &domain = params.restrict_chains[v];
+        int runs = rng() % 4;
+        for (int i = 0; i < runs; i++) {
+            int start = rng() % n_q;
+            int length = rng() % 9;
+            for (int q = start; q < start + length && q < n_q; q++) domain.push_back(q);
+        }
+        for (int i = rng() % 5; i--;) domain.push_back(rng() % n_q);
+    }
+    return params;
+}
+
+TEST(domain_handlers, collect_ranges) {
+    vector<int> domain{7, 3, 4, 5, 5, 10, 9, 0};
+    vector<int> ranges;
+    ASSERT_EQ(find_embedding::domain_handler_ranged::collect_ranges(domain, ranges), 4);
+    ASSERT_EQ(ranges, vector<int>({0, 1, 3, 6, 7, 8, 9, 11}));
+}
+
+TEST(domain_handlers, ranged_matches_masked) {
+    const int n_v = 12, n_f = 3, n_q = 50, n_r = 6;
+    for (unsigned seed = 0; seed < 20; seed++) {
+        auto params = random_restrictions(n_v + n_f, n_q + n_r, seed);
+        find_embedding::domain_handler_masked masked(params, n_v, n_f, n_q, n_r);
+        find_embedding::domain_handler_ranged ranged(params, n_v, n_f, n_q, n_r);
+        const distance_t mask_d = std::numeric_limits<distance_t>::max();
+        for (int u = 0; u < n_v + n_f; u++) {
+            for (int q = 0; q < n_q + n_r; q++) ASSERT_EQ(masked.accepts_qubit(u, q), ranged.accepts_qubit(u, q));
+
+            vector<distance_t> d_masked(n_q), d_ranged(n_q, 17);
+            masked.prepare_distances(d_masked, u, mask_d);
+            ranged.prepare_distances(d_ranged, u, mask_d);
+            ASSERT_EQ(d_masked, d_ranged);
+
+            vector<distance_t> s_masked(n_q, 5), s_ranged(n_q, 5);
+            masked.prepare_distances(s_masked, u, mask_d, 10, 30);
+            ranged.prepare_distances(s_ranged, u, mask_d, 10, 30);
+            ASSERT_EQ(s_masked, s_ranged);
+
+            // the listed qubits are prepared as a full preparation would, and the rest are left alone
+            vector<int> listed{3, 11, 12, 29, 48};
+            vector<distance_t> l_masked(n_q, 5), l_ranged(n_q, 5);
+            masked.prepare_distances(l_masked, u, mask_d, listed);
+            ranged.prepare_distances(l_ranged, u, mask_d, listed);
+            for (int q = 0; q < n_q; q++) {
+                bool in_list = std::find(listed.begin(), listed.end(), q) != listed.end();
+                ASSERT_EQ(l_masked[q], in_list ? d_masked[q] : 5);
+                ASSERT_EQ(l_ranged[q], in_list ? d_masked[q] : 5);
+            }
+
+            for (int v = 0; v < n_v + n_f; v++) {
+                vector<int> v_masked(n_q), v_ranged(n_q, 1);
+                masked.prepare_visited(v_masked, u, v);
+                ranged.prepare_visited(v_ranged, u, v);
+                ASSERT_EQ(v_masked, v_ranged);
+
+                vector<int> w_masked(n_q, 1), w_ranged(n_q, 1);
+                masked.prepare_visited(w_masked, u, v, listed);
+                ranged.prepare_visited(w_ranged, u, v, listed);
+                for (int q = 0; q < n_q; q++) {
+                    bool in_list = std::find(listed.begin(), listed.end(), q) != listed.end();
+                    ASSERT_EQ(w_masked[q], in_list ? v_masked[q] : 1);
+                    ASSERT_EQ(w_ranged[q], in_list ? v_masked[q] : 1);
+                }
+            }
+        }
+    }
+}
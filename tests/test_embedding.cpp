@@ -0,0 +1,253 @@
+#include <memory>
+#include <vector>
+#include "embedding.hpp"
+#include "gtest/gtest.h"
+using namespace find_embedding;
+using std::vector;
+
+typedef embedding_problem<fixed_handler_none, domain_handler_universe, output_handler_error> problem_t;
+
+// a path of four variables, embedded along a path of twelve qubits
+class freeze_stack : public ::testing::Test {
+  protected:
+    int n_v = 4, n_f = 0, n_q = 12, n_r = 0;
+    vector<vector<int>> qubit_nbrs, var_nbrs;
+    optional_parameters params;
+    std::unique_ptr<problem_t> ep;
+
+    void SetUp() override {
+        qubit_nbrs.assign(n_q, {});
+        var_nbrs.assign(n_v, {});
+        for (int q = 0; q + 1 < n_q; q++) qubit_nbrs[q].push_back(q + 1), qubit_nbrs[q + 1].push_back(q);
+        for (int v = 0; v + 1 < n_v; v++) var_nbrs[v].push_back(v + 1), var_nbrs[v + 1].push_back(v);
+        ep.reset(new problem_t(params, n_v, n_f, n_q, n_r, var_nbrs, qubit_nbrs));
+    }
+
+    //! chains {0,1,2}, {3,4,5}, {6,7,8}, {9,10,11}, linked end to end
+    void populate(embedding<problem_t> &emb) {
+        map<int, vector<int>> fixed, initial;
+        for (int v = 0; v < n_v; v++) initial[v] = {3 * v, 3 * v + 1, 3 * v + 2};
+        emb = embedding<problem_t>(*ep, fixed, initial);
+    }
+};
+
+TEST_F(freeze_stack, thaw_restores_adjacent_chains) {
+    embedding<problem_t> emb(*ep), original(*ep);
+    populate(emb);
+    populate(original);
+    ASSERT_TRUE(emb.linked());
+
+    int mark = emb.freeze_mark();
+    ASSERT_EQ(emb.freeze_push(1), 3);
+    ASSERT_EQ(emb.freeze_push(2), 3);
+    ASSERT_EQ(emb.weight(4), 0);
+    ASSERT_FALSE(emb.linked(0));
+
+    // a tentative replacement, which is abandoned
+    emb.set_chain(1, {3, 4});
+    emb.set_chain(2, {5, 6, 7, 8});
+    emb.thaw_to(mark);
+
+    ASSERT_TRUE(emb == original);
+    ASSERT_TRUE(emb.linked());
+    for (int q = 0; q < n_q; q++) ASSERT_EQ(emb.weight(q), 1);
+    for (int v = 0; v < 4; v++)
+        for (auto &w : var_nbrs[v])
+            ASSERT_EQ(emb.get_chain(v).get_link(w), original.get_chain(v).get_link(w));
+}
+
+// a chain placed inside a mark steals from its neighbors, which are restored by the rollback
+TEST_F(freeze_stack, thaw_undoes_steals) {
+    embedding<problem_t> emb(*ep), original(*ep);
+    populate(emb);
+    populate(original);
+
+    int mark = emb.freeze_mark();
+    emb.freeze_push(1);
+
+    // the chain {3, 4, 5} again, rooted at 4, which steals the ends of both neighbors
+    vector<vector<int>> parents(n_v, vector<int>(n_q, -1));
+    parents[0][4] = 3, parents[0][3] = 2;
+    parents[2][4] = 5, parents[2][5] = 6;
+    emb.construct_chain(1, 4, parents);
+    ASSERT_TRUE(emb.linked());
+    emb.steal_all(1);
+    ASSERT_GT(emb.chainsize(1), 3);
+    ASSERT_LT(emb.chainsize(0) + emb.chainsize(2), 6);
+    ASSERT_TRUE(emb.linked());
+
+    emb.thaw_to(mark);
+    ASSERT_TRUE(emb == original);
+    ASSERT_TRUE(emb.linked());
+    for (int q = 0; q < n_q; q++) ASSERT_EQ(emb.weight(q), 1);
+    for (int v = 0; v < 4; v++)
+        for (auto &w : var_nbrs[v])
+            ASSERT_EQ(emb.get_chain(v).get_link(w), original.get_chain(v).get_link(w));
+
+    // and once the stack is empty, changes are no longer saved
+    emb.steal_all(1);
+    ASSERT_EQ(emb.freeze_mark(), 0);
+    emb.commit_to(0);
+}
+
+TEST_F(freeze_stack, nested_commit_and_abort) {
+    embedding<problem_t> emb(*ep), original(*ep);
+    populate(emb);
+    populate(original);
+
+    int outer = emb.freeze_mark();
+    emb.freeze_push(0);
+    int inner = emb.freeze_mark();
+    emb.freeze_push(3);
+    emb.thaw_to(inner);
+    ASSERT_EQ(emb.chainsize(3), 3);
+    ASSERT_EQ(emb.chainsize(0), 0);
+
+    emb.freeze_push(3);
+    emb.commit_to(inner);
+    ASSERT_EQ(emb.freeze_mark(), inner);
+    ASSERT_EQ(emb.chainsize(3), 0);
+
+    emb.thaw_to(outer);
+    ASSERT_EQ(emb.chainsize(0), 3);
+    ASSERT_EQ(emb.chainsize(3), 0);
+    ASSERT_TRUE(emb.linked(0));
+}
+
+// chains torn down and rebuilt reuse the nodes of their pool, and copies between embeddings stay in their own pools
+TEST(node_pool, chains_recycle_nodes) {
+    node_pool pool;
+    vector<fill_t> weight(100, 0);
+    chain c(weight, 0, &pool), d(weight, 1);
+    vector<int> qubits;
+    for (int q = 0; q < 100; q++) qubits.push_back(q);
+
+    c = qubits;
+    size_t capacity = pool.capacity();
+    ASSERT_GT(capacity, 0);
+    for (int i = 0; i < 10; i++) {
+        c.clear();
+        c = qubits;
+    }
+    EXPECT_EQ(pool.capacity(), capacity);
+
+    d = c;
+    EXPECT_EQ(pool.capacity(), capacity);
+    EXPECT_EQ(d.size(), 100);
+    c.clear();
+    for (int q = 0; q < 100; q++) EXPECT_EQ(weight[q], 1);
+}
+
+// fill counts are bytes, so initial chains which would stack more chains than that on one qubit are left out
+TEST(fill_counts, stacked_initial_chains) {
+    int n_v = max_fill_count + 10, n_f = 0, n_q = 4, n_r = 0;
+    vector<vector<int>> qubit_nbrs(n_q), var_nbrs(n_v);
+    for (int q = 0; q + 1 < n_q; q++) qubit_nbrs[q].push_back(q + 1), qubit_nbrs[q + 1].push_back(q);
+    optional_parameters params;
+    problem_t ep(params, n_v, n_f, n_q, n_r, var_nbrs, qubit_nbrs);
+    map<int, vector<int>> fixed, initial;
+    for (int v = 0; v < n_v; v++) initial[v] = {v % 2, 2};
+    embedding<problem_t> emb(ep, fixed, initial);
+    EXPECT_EQ(emb.weight(2), max_fill_count);
+    EXPECT_EQ(emb.weight(0) + emb.weight(1), max_fill_count);
+    EXPECT_EQ(emb.max_weight(), max_fill_count);
+    int placed = 0;
+    for (int v = 0; v < n_v; v++) placed += emb.chainsize(v) > 0;
+    EXPECT_EQ(placed, max_fill_count);
+    for (int v = 0; v < n_v; v++) emb.tear_out(v);
+    EXPECT_EQ(emb.max_weight(), 0);
+}
+
+// initial chains are linked where they touch, or failing that where they overlap, including to fixed chains on
+// reserved qubits, which only have outbound edges; broken chains lose their roots
+TEST(initial_chains, linkup) {
+    typedef embedding_problem<fixed_handler_hival, domain_handler_universe, output_handler_error> fixed_problem_t;
+    int n_v = 4, n_f = 1, n_q = 12, n_r = 1;
+    vector<vector<int>> qubit_nbrs(n_q + n_r), var_nbrs(n_v + n_f);
+    for (int q = 0; q + 1 < n_q; q++) qubit_nbrs[q].push_back(q + 1), qubit_nbrs[q + 1].push_back(q);
+    qubit_nbrs[n_q].push_back(11);
+    // a path 0 - 1 - 2, and 0 - 3 - 4 where 4 is fixed
+    for (auto &e : vector<pair<int, int>>{{0, 1}, {1, 2}, {0, 3}}) {
+        var_nbrs[e.first].push_back(e.second);
+        var_nbrs[e.second].push_back(e.first);
+    }
+    var_nbrs[3].push_back(4);
+    optional_parameters params;
+    fixed_problem_t ep(params, n_v, n_f, n_q, n_r, var_nbrs, qubit_nbrs);
+    map<int, vector<int>> fixed, initial;
+    fixed[4] = {n_q};
+    initial[0] = {0, 1, 2};
+    initial[1] = {3, 4};
+    initial[2] = {6, 8};
+    initial[3] = {2};
+    embedding<fixed_problem_t> emb(ep, fixed, initial);
+
+    auto &c0 = emb.get_chain(0), &c1 = emb.get_chain(1), &c2 = emb.get_chain(2), &c3 = emb.get_chain(3),
+         &c4 = emb.get_chain(4);
+    EXPECT_EQ(c0.get_link(0), 0);
+    EXPECT_EQ(c1.get_link(1), 3);
+    EXPECT_EQ(c2.get_link(2), -1);
+    EXPECT_EQ(c0.get_link(1), 2);
+    EXPECT_EQ(c1.get_link(0), 3);
+    EXPECT_EQ(c1.get_link(2), -1);
+    EXPECT_EQ(c2.get_link(1), -1);
+    EXPECT_EQ(c0.get_link(3), 1);
+    EXPECT_EQ(c3.get_link(0), 2);
+    EXPECT_EQ(c3.get_link(4), -1);
+    EXPECT_EQ(c4.get_link(3), -1);
+    EXPECT_EQ(c0.parent(2), 1);
+    EXPECT_EQ(c0.parent(1), 0);
+    EXPECT_TRUE(emb.linked(0));
+    EXPECT_FALSE(emb.linked(3));
+
+    // the fixed chain is linked from its reserved qubit, at the end of the path
+    initial[3] = {10, 11};
+    embedding<fixed_problem_t> emb2(ep, fixed, initial);
+    EXPECT_EQ(emb2.get_chain(3).get_link(4), 11);
+    EXPECT_EQ(emb2.get_chain(4).get_link(3), n_q);
+    EXPECT_EQ(emb2.get_chain(3).get_link(0), -1);
+
+    // chains which share a qubit, and hold no neighbors of one another, are linked at that qubit
+    initial[0] = {5};
+    initial[3] = {5};
+    embedding<fixed_problem_t> emb3(ep, fixed, initial);
+    EXPECT_EQ(emb3.get_chain(0).get_link(3), 5);
+    EXPECT_EQ(emb3.get_chain(3).get_link(0), 5);
+    EXPECT_EQ(emb3.get_chain(0).get_link(1), 5);
+    EXPECT_EQ(emb3.get_chain(1).get_link(0), 4);
+}
+
+namespace {
+class recording_interaction : public LocalInteraction {
+  public:
+    mutable vector<std::string> lines;
+
+  private:
+    virtual void displayOutputImpl(const std::string &msg) const { lines.push_back(msg); }
+    virtual bool cancelledImpl() const { return false; }
+};
+}
+
+// each initial chain left out for lack of room in the fill counts is reported at the major_info verbosity level
+TEST(fill_counts, dropped_chains_reported) {
+    typedef embedding_problem<fixed_handler_none, domain_handler_universe, output_handler_full> verbose_problem_t;
+    int n_v = max_fill_count + 2, n_f = 0, n_q = 3, n_r = 0;
+    vector<vector<int>> qubit_nbrs{{2}, {2}, {0, 1}}, var_nbrs(n_v);
+    auto output = std::make_shared<recording_interaction>();
+    optional_parameters params;
+    params.localInteractionPtr = output;
+    params.verbose = 1;
+    verbose_problem_t ep(params, n_v, n_f, n_q, n_r, var_nbrs, qubit_nbrs);
+    map<int, vector<int>> fixed, initial;
+    for (int v = 0; v < n_v; v++) initial[v] = {v % 2, 2};
+    embedding<verbose_problem_t> emb(ep, fixed, initial);
+    EXPECT_EQ(emb.weight(2), max_fill_count);
+    ASSERT_EQ(output->lines.size(), 2);
+    const std::string fill = std::to_string(max_fill_count);
+    EXPECT_EQ(output->lines[0], "initial chain for " + fill + " dropped: qubit 2 already holds " + fill + " chains\n");
+
+    params.verbose = 0;
+    output->lines.clear();
+    embedding<verbose_problem_t> quiet(ep, fixed, initial);
+    EXPECT_TRUE(output->lines.empty());
+}
@@ -0,0 +1,43 @@
+#include <cstdint>
+#include <limits>
+#include "fastrng.hpp"
+#include "gtest/gtest.h"
+
+static void step(fastrng &rng, uint64_t n) {
+    while (n--) rng();
+}
+
+// discard(n) must land where n draws do, on either side of the cutoff for jumping by polynomial
+TEST(fastrng, discard_matches_draws) {
+    for (uint64_t n : {0, 1, 100, 255, 256, 1000, 4097}) {
+        fastrng a(UINT64_C(12345)), b(UINT64_C(12345));
+        a.discard(n);
+        step(b, n);
+        for (int i = 0; i < 4; i++) ASSERT_EQ(a(), b()) << "n = " << n;
+    }
+}
+
+// seeding skips 1024 draws past the state given by splitmix, as it always has
+TEST(fastrng, seed_skips_1024) {
+    for (uint64_t x : {UINT64_C(0), UINT64_C(7), UINT64_C(0xdeadbeefcafe)}) {
+        fastrng a, b(x);
+        a.seed(x);
+        step(b, 1024);
+        ASSERT_EQ(a(), b());
+    }
+}
+
+// the constant jump agrees with jumping by a computed polynomial, and split streams start where they should
+TEST(fastrng, jump_and_split) {
+    fastrng a(UINT64_C(99)), b(UINT64_C(99));
+    a.jump();
+    b.discard(UINT64_C(1) << 63);
+    b.discard(UINT64_C(1) << 63);
+    ASSERT_EQ(a(), b());
+
+    fastrng parent(UINT64_C(99)), original(UINT64_C(99)), jumped(UINT64_C(99));
+    jumped.jump();
+    fastrng child = parent.split();
+    for (int i = 0; i < 4; i++) ASSERT_EQ(child(), original());
+    for (int i = 0; i < 4; i++) ASSERT_EQ(parent(), jumped());
+}
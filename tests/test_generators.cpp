@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <set>
+#include <vector>
+#include "generators.hpp"
+#include "gtest/gtest.h"
+using std::vector;
+
+static vector<std::set<int>> neighborhoods(const graph::input_graph &g) {
+    vector<std::set<int>> nbrs(g.num_nodes());
+    for (int i = 0; i < g.num_edges(); i++) {
+        EXPECT_NE(g.a(i), g.b(i));
+        EXPECT_TRUE(nbrs[g.a(i)].insert(g.b(i)).second);
+        EXPECT_TRUE(nbrs[g.b(i)].insert(g.a(i)).second);
+    }
+    return nbrs;
+}
+
+static int count_nonisolated(const vector<std::set<int>> &nbrs) {
+    return std::count_if(nbrs.begin(), nbrs.end(), [](const std::set<int> &n) { return n.size() > 0; });
+}
+
+// node and edge counts agree with dwave_networkx
+TEST(generators, hardware_graphs) {
+    auto c = graph::chimera(16);
+    EXPECT_EQ(c.num_nodes(), 2048);
+    EXPECT_EQ(c.num_edges(), 6016);
+    neighborhoods(c);
+
+    auto c_rect = graph::chimera(2, 3, 2);
+    EXPECT_EQ(c_rect.num_nodes(), 24);
+    EXPECT_EQ(c_rect.num_edges(), 6 * 4 + 3 * 2 + 4 * 2);
+
+    auto p = graph::pegasus(16);
+    auto p_nbrs = neighborhoods(p);
+    EXPECT_EQ(p.num_nodes(), 5760);
+    EXPECT_EQ(count_nonisolated(p_nbrs), 5640);
+    EXPECT_EQ(p.num_edges(), 40484);
+    auto p6 = graph::pegasus(6);
+    EXPECT_EQ(count_nonisolated(neighborhoods(p6)), 680);
+    EXPECT_EQ(p6.num_edges(), 4484);
+    size_t p_degree = 0;
+    for (auto &n : p_nbrs) p_degree = std::max(p_degree, n.size());
+    EXPECT_EQ(p_degree, 15);
+
+    auto z = graph::zephyr(4);
+    auto z_nbrs = neighborhoods(z);
+    EXPECT_EQ(z.num_nodes(), 576);
+    EXPECT_EQ(count_nonisolated(z_nbrs), 576);
+    EXPECT_EQ(z.num_edges(), 5032);
+    size_t z_degree = 0;
+    for (auto &n : z_nbrs) z_degree = std::max(z_degree, n.size());
+    EXPECT_EQ(z_degree, 20);
+}
+
+TEST(generators, defects) {
+    auto c = graph::chimera(8);
+    auto d = graph::random_defects(c, .1, .05, 3);
+    auto e = graph::random_defects(c, .1, .05, 3);
+    EXPECT_EQ(d.num_nodes(), c.num_nodes());
+    EXPECT_LT(d.num_edges(), c.num_edges());
+    ASSERT_EQ(d.num_edges(), e.num_edges());
+    for (int i = 0; i < d.num_edges(); i++) EXPECT_EQ(std::make_pair(d.a(i), d.b(i)), std::make_pair(e.a(i), e.b(i)));
+    auto nbrs = neighborhoods(c);
+    for (int i = 0; i < d.num_edges(); i++) EXPECT_EQ(nbrs[d.a(i)].count(d.b(i)), 1);
+    EXPECT_EQ(graph::random_defects(c, 0, 0, 3).num_edges(), c.num_edges());
+}
+
+TEST(generators, source_graphs) {
+    auto k = graph::clique(12);
+    EXPECT_EQ(k.num_edges(), 66);
+    neighborhoods(k);
+
+    auto g = graph::grid(5, 7);
+    EXPECT_EQ(g.num_nodes(), 35);
+    EXPECT_EQ(g.num_edges(), 4 * 7 + 5 * 6);
+    neighborhoods(g);
+
+    for (int d : {3, 4, 7}) {
+        auto r = graph::random_regular(200, d, d);
+        auto nbrs = neighborhoods(r);
+        ASSERT_EQ(r.num_nodes(), 200);
+        for (auto &n : nbrs) EXPECT_EQ(n.size(), d);
+    }
+    EXPECT_THROW(graph::random_regular(7, 3, 0), find_embedding::MinorMinerException);
+    EXPECT_THROW(graph::random_regular(4, 4, 0), find_embedding::MinorMinerException);
+}
+
+// the geometric graph has exactly the edges between points within the radius
+TEST(generators, random_geometric) {
+    for (double radius : {.02, .1, .5, 2.}) {
+        vector<double> xy;
+        auto g = graph::random_geometric(300, radius, 7, &xy);
+        auto nbrs = neighborhoods(g);
+        ASSERT_EQ(xy.size(), 600);
+        for (int a = 0; a < 300; a++) {
+            for (int b = a + 1; b < 300; b++) {
+                double dx = xy[2 * a] - xy[2 * b], dy = xy[2 * a + 1] - xy[2 * b + 1];
+                EXPECT_EQ(nbrs[a].count(b), dx * dx + dy * dy <= radius * radius);
+            }
+        }
+    }
+}
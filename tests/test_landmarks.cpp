@@ -0,0 +1,115 @@
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "landmarks.hpp"
+using find_embedding::landmark_table;
+using std::vector;
+
+static vector<int> hop_counts(const vector<vector<int>> &nbrs, int source) {
+    vector<int> hops(nbrs.size(), -1);
+    vector<int> level{source};
+    hops[source] = 0;
+    for (int d = 1; level.size(); d++) {
+        vector<int> next;
+        for (auto &q : level)
+            for (auto &p : nbrs[q])
+                if (hops[p] < 0) {
+                    hops[p] = d;
+                    next.push_back(p);
+                }
+        level.swap(next);
+    }
+    return hops;
+}
+
+// lower bounds must never exceed the true hop counts, between pairs of qubits or between a qubit and a set
+TEST(landmarks, bounds_are_admissible) {
+    const int n = 400;
+    std::mt19937 rng(3);
+    vector<vector<int>> nbrs(n);
+    for (int i = 0; i < 2 * n; i++) {
+        int a = rng() % n, b = rng() % n;
+        if (a == b) continue;
+        nbrs[a].push_back(b);
+        nbrs[b].push_back(a);
+    }
+    landmark_table table(nbrs, 8);
+    ASSERT_GT(table.size(), 1);
+
+    for (int trial = 0; trial < 20; trial++) {
+        vector<int> set{int(rng() % n), int(rng() % n), int(rng() % n)};
+        vector<int> lo, hi;
+        table.summarize(set, lo, hi);
+        vector<vector<int>> from;
+        for (auto &s : set) from.push_back(hop_counts(nbrs, s));
+        for (int q = 0; q < n; q++) {
+            int nearest = -1;
+            for (auto &h : from)
+                if (h[q] >= 0 && (nearest < 0 || h[q] < nearest)) nearest = h[q];
+            if (nearest < 0) continue;
+            ASSERT_LE(table.lower_bound(lo, hi, q), nearest);
+            ASSERT_LE(table.lower_bound(set[0], q), from[0][q] < 0 ? 0 : from[0][q]);
+        }
+    }
+}
+
+// tables are shared between callers with the same adjacency, and freed once no caller holds them
+TEST(landmarks, shared_tables) {
+    vector<vector<int>> path(50), ring(50);
+    for (int i = 0; i + 1 < 50; i++) {
+        path[i].push_back(i + 1);
+        path[i + 1].push_back(i);
+    }
+    ring = path;
+    ring[0].push_back(49);
+    ring[49].push_back(0);
+    auto a = landmark_table::shared(path, 4);
+    auto b = landmark_table::shared(ring, 4);
+    auto c = landmark_table::shared(path, 4);
+    EXPECT_EQ(a, c);
+    EXPECT_NE(a, b);
+    // the ends of a path are picked first, so bounds along it are exact
+    EXPECT_EQ(a->lower_bound(3, 40), 37);
+
+    std::weak_ptr<const landmark_table> held = a;
+    a.reset();
+    EXPECT_FALSE(held.expired());
+    c.reset();
+    EXPECT_TRUE(held.expired());
+    EXPECT_EQ(landmark_table::shared(path, 4)->lower_bound(3, 40), 37);
+}
+
+namespace {
+struct keyed_tables : landmark_table {
+    using landmark_table::shared;
+};
+}
+
+// a table found under the fingerprint of another graph is only shared if the edge count and a sample of its hop
+// counts agree with the graph; otherwise, the fingerprints are taken to collide and a new table is built
+TEST(landmarks, fingerprint_collisions) {
+    vector<vector<int>> path(50), ring, shuffled(50);
+    for (int i = 0; i + 1 < 50; i++) {
+        path[i].push_back(i + 1);
+        path[i + 1].push_back(i);
+    }
+    ring = path;
+    ring[0].push_back(49);
+    ring[49].push_back(0);
+    // the same number of edges as the path, but the path's hop counts don't fit it
+    for (int i = 0; i + 1 < 50; i++) {
+        int a = (7 * i) % 50, b = (7 * (i + 1)) % 50;
+        shuffled[a].push_back(b);
+        shuffled[b].push_back(a);
+    }
+    const uint64_t key = 12345;
+    auto a = keyed_tables::shared(path, 4, key);
+    EXPECT_EQ(keyed_tables::shared(path, 4, key), a);
+    auto b = keyed_tables::shared(ring, 4, key);
+    auto c = keyed_tables::shared(shuffled, 4, key);
+    EXPECT_NE(b, a);
+    EXPECT_NE(c, a);
+    EXPECT_NE(c, b);
+    EXPECT_EQ(c->lower_bound(0, 7), 1);
+    EXPECT_EQ(keyed_tables::shared(shuffled, 4, key), c);
+}
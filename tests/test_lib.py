@@ -4,7 +4,7 @@
     TODO ADD MORE
 """
 from __future__ import print_function
-from minorminer import find_embedding as find_embedding_orig
+from minorminer import find_embedding as find_embedding_orig, verify_embedding, EmbeddingError
 import networkx as nx
 import dwave_networkx as dnx
 from warnings import warn
@@ -16,13 +16,16 @@ import time
 # in a sub directory. Use the path of this source file to find the calibration
 calibration_dir = os.path.join(os.path.dirname(
     os.path.abspath(__file__)), "calibration")
+profile_dir = os.path.join(calibration_dir, "profile")
 
 
 def find_embedding(Q, A, return_overlap=False, **args):
     args['verbose'] = 0
     args['tries'] = 1
+    if profile_overrides is not None:
+        args.update(profile_overrides)
     if return_overlap:
-        emb, succ = find_embedding_orig(
+        emb, succ = find_embedding_timed(
             Q, A, return_overlap=return_overlap, **args)
         if not succ:
             return emb, succ
@@ -34,7 +37,7 @@ def find_embedding(Q, A, return_overlap=False, **args):
             raise RuntimeError(
                 "bad embedding reported as success (%s)" % (check_embedding.errcode))
     else:
-        emb = find_embedding_orig(Q, A, return_overlap=return_overlap, **args)
+        emb = find_embedding_timed(Q, A, return_overlap=return_overlap, **args)
         if emb:
             if not check_embedding(Q, A, emb, **args):
                 raise RuntimeError(
@@ -44,6 +47,23 @@ def find_embedding(Q, A, return_overlap=False, **args):
         return emb
 
 
+# while a scenario is profiled, these parameters override those given to find_embedding, and each call is recorded
+# in profile_calls as a pair (seconds, max chain length), where the chain length is None if the call failed
+profile_overrides = None
+profile_calls = []
+
+
+def find_embedding_timed(Q, A, return_overlap=False, **args):
+    if profile_overrides is None:
+        return find_embedding_orig(Q, A, return_overlap=return_overlap, **args)
+    t0 = time.time()
+    result = find_embedding_orig(Q, A, return_overlap=return_overlap, **args)
+    dt = time.time() - t0
+    emb, succ = result if return_overlap else (result, bool(result))
+    profile_calls.append((dt, max(len(c) for c in emb.values()) if succ and emb else None))
+    return result
+
+
 def check_embedding(Q, A, emb, **args):
     check_embedding.warning = None
     Qg = Q if hasattr(Q, 'edges') else nx.Graph(Q)
@@ -250,6 +270,126 @@ def calibrate_new(directory=calibration_dir, M=None):
             calibrate_success_count(f, n, a, k, directory=directory, M=M)
 
 
+def profile_scenario(f, a, k, seed, first=False):
+    """Runs the scenario `f(*a, **k)` with a fixed seed, for the library and for python's random module, and returns
+    the total seconds spent in find_embedding and the greatest max chain length over its calls (None on failure).  If
+    `first` is set, chain lengths are not reduced, so the time is that taken to find a first embedding."""
+    global profile_overrides, profile_calls
+    from random import seed as py_seed
+    py_seed(seed)
+    profile_overrides = {'random_seed': seed}
+    if first:
+        profile_overrides['chainlength_patience'] = 0
+    profile_calls = []
+    try:
+        succ = f(*a, **k)
+    finally:
+        profile_overrides = None
+    t = sum(dt for dt, _ in profile_calls)
+    lengths = [l for _, l in profile_calls]
+    if not succ or not lengths or None in lengths:
+        return t, None
+    return t, max(lengths)
+
+
+def profile_success_count(f, a, k, seeds, directory=profile_dir):
+    """Records a time-to-quality baseline for the scenario `f`: for each seed, the time to a first embedding, the
+    time to the final embedding, and the max chain length of the final embedding."""
+    record = {'seeds': list(seeds), 'first': [], 'final': [], 'chainlength': []}
+    print("profiling %s over %d seeds " % (f.__name__, len(record['seeds'])), end='')
+    for s in record['seeds']:
+        record['first'].append(profile_scenario(f, a, k, s, first=True)[0])
+        t, length = profile_scenario(f, a, k, s)
+        record['final'].append(t)
+        record['chainlength'].append(length)
+        print(".", end='')
+        sys.stdout.flush()
+    print()
+    with open(os.path.join(directory, f.__name__), "w") as prof_f:
+        prof_f.write(repr(record))
+    return record
+
+
+def load_profile(f, directory=profile_dir):
+    with open(os.path.join(directory, f.__name__)) as prof_f:
+        return eval(prof_f.read())
+
+
+def profile_all(directory=profile_dir, seeds=range(16), new_only=False):
+    """Records time-to-quality baselines for every calibrated scenario"""
+    if not os.path.exists(directory):
+        os.makedirs(directory)
+    for f, n, a, k in success_count_functions:
+        if new_only and os.path.exists(os.path.join(directory, f.__name__)):
+            continue
+        profile_success_count(f, a, k, seeds, directory=directory)
+
+
+def profile_new(directory=profile_dir, seeds=range(16)):
+    profile_all(directory=directory, seeds=seeds, new_only=True)
+
+
+def sign_test(wins, losses):
+    """The one-sided p-value of seeing at least `wins` of `wins + losses` fair coin flips come up heads"""
+    from math import factorial
+    n = wins + losses
+    if n == 0:
+        return 1.
+    return sum(factorial(n) // (factorial(j) * factorial(n - j)) for j in range(wins, n + 1)) / 2.**n
+
+
+def compare_profiles(directory=profile_dir, alpha=.01, tolerance=.1):
+    """Profiles each scenario with a baseline in `directory` over the same seeds, and flags those which have become
+    slower (to a first embedding, or to the final one), have found longer chains, or have failed more often.  A
+    slowdown is flagged when the seeds on which the scenario ran slower are significant by a sign test at level
+    `alpha`, and the geometric mean slowdown exceeds `tolerance`; longer chains and failures are flagged on
+    significance alone.  Returns a dictionary mapping the
+    names of flagged scenarios to the list of regressed measures."""
+    from math import exp, log
+    flagged = {}
+    for f, n, a, k in success_count_functions:
+        if not os.path.exists(os.path.join(directory, f.__name__)):
+            continue
+        base = load_profile(f, directory=directory)
+        current = {'first': [], 'final': [], 'chainlength': []}
+        for s in base['seeds']:
+            current['first'].append(profile_scenario(f, a, k, s, first=True)[0])
+            t, length = profile_scenario(f, a, k, s)
+            current['final'].append(t)
+            current['chainlength'].append(length)
+
+        regressions = []
+        report = []
+        for measure in ('first', 'final'):
+            pairs = [(b, c) for b, c in zip(base[measure], current[measure]) if b > 0 and c > 0]
+            if not pairs:
+                continue
+            ratio = exp(sum(log(c / b) for b, c in pairs) / len(pairs))
+            p = sign_test(sum(c > b for b, c in pairs), sum(c < b for b, c in pairs))
+            report.append("%s x%.02f (p=%.03g)" % (measure, ratio, p))
+            if p < alpha and ratio > 1 + tolerance:
+                regressions.append(measure)
+        pairs = [(b, c) for b, c in zip(base['chainlength'], current['chainlength']) if b is not None and c is not None]
+        p = sign_test(sum(c > b for b, c in pairs), sum(c < b for b, c in pairs))
+        report.append("chainlength p=%.03g" % p)
+        if p < alpha:
+            regressions.append('chainlength')
+        # failures are paired by seed, as chain lengths are: seeds which newly fail against those which newly succeed
+        pairs = list(zip(base['chainlength'], current['chainlength']))
+        new_failures = sum(b is not None and c is None for b, c in pairs)
+        new_successes = sum(b is None and c is not None for b, c in pairs)
+        p = sign_test(new_failures, new_successes)
+        if new_failures > new_successes:
+            report.append("%d more failures (p=%.03g)" % (new_failures - new_successes, p))
+        if p < alpha:
+            regressions.append('failures')
+
+        print("%s: %s%s" % (f.__name__, ", ".join(report), " REGRESSED" if regressions else ""))
+        if regressions:
+            flagged[f.__name__] = regressions
+    return flagged
+
+
 def success_perfect(n, *a, **k):
     from functools import wraps
 
@@ -629,6 +769,111 @@ def test_clique_parallel(n, k):
     return find_embedding(cliq, chim, chainlength_patience=0, threads=2)
 
 
+@success_perfect(3, 6, 25)
+def test_clique_parallel_reproducible(n, k):
+    from random import randint
+    chim = Chimera(n)
+    cliq = Clique(k)
+    seed = randint(0, 2**32 - 1)
+
+    embs = [find_embedding(cliq, chim, chainlength_patience=0, random_seed=seed, threads=t) for t in (1, 2, 4)]
+    return embs[0] == embs[1] == embs[2]
+
+
+@success_count(30, 6, 25)
+def test_clique_windowed(n, k):
+    chim = Chimera(n)
+    cliq = Clique(k)
+
+    return find_embedding(cliq, chim, chainlength_patience=0, placement_window=2)
+
+
+@success_perfect(3, 6, 16)
+def test_clique_windowed_chainlength(n, k):
+    chim = Chimera(n)
+    cliq = Clique(k)
+
+    # the chainlength phase places chains inside the window as well
+    emb = find_embedding(cliq, chim, chainlength_patience=10, placement_window=2)
+    return emb and verify_embedding(emb, cliq, chim)
+
+
+@success_count(30, 5)
+def test_grid_windowed(n):
+    chim = Chimera(n)
+    grid = Grid(2 * n)
+
+    # a window of a single hop frequently holds no root, so the global fallback is exercised
+    return find_embedding(grid, chim, placement_window=1)
+
+
+@success_count(30, 6, 25)
+def test_clique_order_pool(n, k):
+    chim = Chimera(n)
+    cliq = Clique(k)
+
+    return find_embedding(cliq, chim, chainlength_patience=0, order_pool=4, threads=2)
+
+
+@success_count(30, 6, 25)
+def test_clique_adaptive(n, k):
+    chim = Chimera(n)
+    cliq = Clique(k)
+
+    return find_embedding(cliq, chim, chainlength_patience=0, adaptive_schedule=True, timeout=10)
+
+
+@success_perfect(3, 16)
+def test_clique_adaptive_timeout(n):
+    chim = Chimera(n)
+    cliq = Clique(4 * n + 2)
+
+    # the adaptive schedule searches until the timeout, and gives up gracefully there
+    return not find_embedding(cliq, chim, chainlength_patience=0, adaptive_schedule=True, timeout=1)
+
+
+@success_count(30, 6, 25)
+def test_clique_lexicographic_weights(n, k):
+    chim = Chimera(n)
+    cliq = Clique(k)
+
+    return find_embedding(cliq, chim, chainlength_patience=0, lexicographic_weights=True)
+
+
+@success_perfect(1)
+def test_memory_budget():
+    chim = Chimera(4)
+    cliq = Clique(8)
+
+    # a budget too small for the problem is refused before the search starts
+    try:
+        find_embedding(cliq, chim, memory_budget=1000)
+        return False
+    except RuntimeError:
+        pass
+    return find_embedding(cliq, chim, memory_budget=1 << 30)
+
+
+@success_perfect(1)
+def test_verify_embedding():
+    chim = Chimera(4)
+    cliq = Clique(8)
+
+    # find_embedding checks its results with check_embedding, which verify_embedding must agree with
+    emb = find_embedding(cliq, chim)
+    if not emb or not verify_embedding(emb, cliq, chim, threads=2):
+        return False
+    for x, y in cliq.edges():
+        bad = dict(emb)
+        bad[x] = bad[x] + bad[y][:1]
+        try:
+            verify_embedding(bad, cliq, chim)
+            return False
+        except EmbeddingError:
+            pass
+    return True
+
+
 @success_count(30, 3, 13)
 def test_clique_term(n, k):
     chim = Chimera(n)
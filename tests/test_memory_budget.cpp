@@ -0,0 +1,54 @@
+#include <vector>
+#include "find_embedding.hpp"
+#include "generators.hpp"
+#include "gtest/gtest.h"
+using namespace find_embedding;
+using std::vector;
+
+namespace {
+class quiet_interaction : public LocalInteraction {
+    virtual void displayOutputImpl(const std::string &) const {}
+    virtual bool cancelledImpl() const { return false; }
+};
+}
+
+TEST(memory_budget, estimate_scales) {
+    size_t small = estimate_memory(100, 0, 2048, 0, 600, 12032, RESTRICT_NONE, 0, 0, 0, 1, 0);
+    size_t more_vars = estimate_memory(200, 0, 2048, 0, 1200, 12032, RESTRICT_NONE, 0, 0, 0, 1, 0);
+    size_t more_qubits = estimate_memory(100, 0, 4096, 0, 600, 24064, RESTRICT_NONE, 0, 0, 0, 1, 0);
+    EXPECT_GT(more_vars, small);
+    EXPECT_GT(more_qubits, small);
+    // the tables over variables and qubits dominate
+    EXPECT_GT(small, 100 * 2048 * (3 * sizeof(int) + sizeof(distance_t)));
+    EXPECT_GT(estimate_memory(100, 0, 2048, 0, 600, 12032, RESTRICT_MASKED, 100, 20480, 10240, 1, 0),
+              estimate_memory(100, 0, 2048, 0, 600, 12032, RESTRICT_RANGED, 100, 20480, 10240, 1, 0));
+}
+
+// restrictions to every fourth qubit are held as masks by default; given a budget that only fits the ranges, those
+// are used instead, and a budget too small for either is refused
+TEST(memory_budget, fallback_and_refusal) {
+    graph::input_graph source = graph::clique(8), target = graph::chimera(4);
+    size_t num_v = 8, num_q = target.num_nodes(), var_degree = 56, qubit_degree = 2 * target.num_edges();
+    size_t restricted_qubits = num_v * num_q / 4;
+    // there can be no more ranges than qubits
+    size_t ranged = estimate_memory(num_v, 0, num_q, 0, var_degree, qubit_degree, RESTRICT_RANGED, num_v,
+                                    restricted_qubits, restricted_qubits, 1, 0);
+    size_t masked = estimate_memory(num_v, 0, num_q, 0, var_degree, qubit_degree, RESTRICT_MASKED, num_v,
+                                    restricted_qubits, 0, 1, 0);
+    ASSERT_LT(ranged, masked);
+
+    for (size_t budget : {size_t(0), masked, ranged, ranged / 2}) {
+        optional_parameters params;
+        params.localInteractionPtr.reset(new quiet_interaction());
+        params.tries = 1;
+        params.memory_budget = budget;
+        for (int v = 0; v < int(num_v); v++)
+            for (int q = v % 4; q < int(num_q); q += 4) params.restrict_chains[v].push_back(q);
+        vector<vector<int>> chains;
+        if (budget == ranged / 2) {
+            EXPECT_THROW(findEmbedding(source, target, params, chains), MemoryBudgetException);
+        } else {
+            EXPECT_NO_THROW(findEmbedding(source, target, params, chains));
+        }
+    }
+}
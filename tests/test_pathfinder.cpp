@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <vector>
+#include "gtest/gtest.h"
+#include "pathfinder.hpp"
+using namespace find_embedding;
+using std::vector;
+
+namespace {
+class quiet_interaction : public LocalInteraction {
+    virtual void displayOutputImpl(const std::string &) const {}
+    virtual bool cancelledImpl() const { return false; }
+};
+
+typedef embedding_problem<fixed_handler_none, domain_handler_universe, output_handler_error> problem_t;
+
+// the complete graph on n nodes
+vector<vector<int>> clique(int n) {
+    vector<vector<int>> nbrs(n);
+    for (int a = 0; a < n; a++)
+        for (int b = 0; b < n; b++)
+            if (a != b) nbrs[a].push_back(b);
+    return nbrs;
+}
+
+// an m x m chimera graph, with qubit k of shore s of the cell in row i and column j labeled ((mi + j)2 + s)4 + k
+vector<vector<int>> chimera(int m) {
+    vector<vector<int>> nbrs(8 * m * m);
+    auto label = [m](int i, int j, int s, int k) { return ((i * m + j) * 2 + s) * 4 + k; };
+    auto couple = [&nbrs](int p, int q) {
+        nbrs[p].push_back(q);
+        nbrs[q].push_back(p);
+    };
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < m; j++)
+            for (int k = 0; k < 4; k++) {
+                for (int l = 0; l < 4; l++) couple(label(i, j, 0, k), label(i, j, 1, l));
+                if (i + 1 < m) couple(label(i, j, 0, k), label(i + 1, j, 0, k));
+                if (j + 1 < m) couple(label(i, j, 1, k), label(i, j + 1, 1, k));
+            }
+    return nbrs;
+}
+
+// the chains are nonempty, disjoint and connected, and every edge of the source joins two chains
+bool valid_embedding(const vector<vector<int>> &var_nbrs, const vector<vector<int>> &qubit_nbrs,
+                     const vector<vector<int>> &chains) {
+    vector<int> owner(qubit_nbrs.size(), -1);
+    for (int v = 0; v < static_cast<int>(chains.size()); v++) {
+        if (chains[v].empty()) return false;
+        for (auto &q : chains[v]) {
+            if (owner[q] != -1) return false;
+            owner[q] = v;
+        }
+    }
+    for (int v = 0; v < static_cast<int>(chains.size()); v++) {
+        vector<int> reached{chains[v][0]}, seen(qubit_nbrs.size(), 0);
+        seen[chains[v][0]] = 1;
+        for (size_t i = 0; i < reached.size(); i++)
+            for (auto &p : qubit_nbrs[reached[i]])
+                if (owner[p] == v && !seen[p]) seen[p] = 1, reached.push_back(p);
+        if (reached.size() != chains[v].size()) return false;
+        for (auto &u : var_nbrs[v]) {
+            bool linked = false;
+            for (auto &q : chains[v])
+                for (auto &p : qubit_nbrs[q]) linked |= owner[p] == u;
+            if (!linked) return false;
+        }
+    }
+    return true;
+}
+
+template <typename pathfinder_t>
+vector<vector<int>> embed(vector<vector<int>> var_nbrs, vector<vector<int>> qubit_nbrs,
+                          int chainlength_patience, int placement_window, int threads) {
+    int n_v = var_nbrs.size(), n_q = qubit_nbrs.size();
+    optional_parameters params;
+    params.localInteractionPtr.reset(new quiet_interaction());
+    params.tries = 1;
+    params.chainlength_patience = chainlength_patience;
+    params.placement_window = placement_window;
+    params.threads = threads;
+    params.seed(3);
+    pathfinder_t pf(params, n_v, 0, n_q, 0, var_nbrs, qubit_nbrs);
+    vector<vector<int>> chains(n_v);
+    if (pf.heuristicEmbedding() == 1)
+        for (int v = 0; v < n_v; v++)
+            for (auto &q : pf.get_chain(v)) chains[v].push_back(q);
+    for (auto &c : chains) std::sort(c.begin(), c.end());
+    return chains;
+}
+
+int total_size(const vector<vector<int>> &chains) {
+    int total = 0;
+    for (auto &c : chains) total += c.size();
+    return total;
+}
+}
+
+// a fixed chain on three reserved qubits, each next to all six free qubits: the searches from it queue each free qubit
+// once, rather than once per chain qubit, which would overflow a queue of num_qubits nodes
+TEST(fixed_chains, shared_neighbors_queued_once) {
+    typedef embedding_problem<fixed_handler_hival, domain_handler_universe, output_handler_error> problem_t;
+    int n_v = 2, n_f = 1, n_q = 6, n_r = 3;
+    vector<vector<int>> var_nbrs{{1, 2}, {0, 2}, {0, 1}}, qubit_nbrs(n_q + n_r);
+    // free qubits are joined to each other; reserved qubits only list their free neighbors
+    for (int q = 0; q < n_q; q++) {
+        for (int p = 0; p < n_q; p++)
+            if (p != q) qubit_nbrs[q].push_back(p);
+        for (int r = n_q; r < n_q + n_r; r++) qubit_nbrs[r].push_back(q);
+    }
+
+    optional_parameters params;
+    params.localInteractionPtr.reset(new quiet_interaction());
+    params.tries = 1;
+    params.seed(1);
+    params.fixed_chains[n_v] = {6, 7, 8};
+    pathfinder_serial<problem_t> pf(params, n_v, n_f, n_q, n_r, var_nbrs, qubit_nbrs);
+    ASSERT_EQ(pf.heuristicEmbedding(), 1);
+    EXPECT_EQ(pf.get_chain(0).size(), 1);
+    EXPECT_EQ(pf.get_chain(1).size(), 1);
+}
+
+// the chainlength phase runs inside the window: it keeps a valid embedding and only ever shortens it, and its
+// threaded searches find the same chains as the serial ones
+TEST(placement_window, chainlength) {
+    auto source = clique(10), target = chimera(4);
+    for (int window : {1, 2}) {
+        auto before = embed<pathfinder_serial<problem_t>>(source, target, 0, window, 1);
+        auto after = embed<pathfinder_serial<problem_t>>(source, target, 10, window, 1);
+        ASSERT_TRUE(valid_embedding(source, target, before));
+        ASSERT_TRUE(valid_embedding(source, target, after));
+        EXPECT_LE(total_size(after), total_size(before));
+        EXPECT_EQ(embed<pathfinder_hybrid<problem_t>>(source, target, 10, window, 3), after);
+    }
+}
+
+// on a target large enough for landmarks, the threaded searches share the radius found on the calling thread, and
+// find the same chains as the serial ones
+TEST(search_radius, threaded) {
+    auto source = clique(12), target = chimera(12);
+    ASSERT_GE(target.size(), 1024);
+    auto serial = embed<pathfinder_serial<problem_t>>(source, target, 2, 0, 1);
+    ASSERT_TRUE(valid_embedding(source, target, serial));
+    EXPECT_EQ(embed<pathfinder_parallel<problem_t>>(source, target, 2, 0, 3), serial);
+    EXPECT_EQ(embed<pathfinder_hybrid<problem_t>>(source, target, 2, 0, 3), serial);
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "embedding.hpp"
+#include "gtest/gtest.h"
+using namespace find_embedding;
+using std::vector;
+
+typedef embedding_problem<fixed_handler_none, domain_handler_universe, output_handler_error> problem_t;
+
+// chainsize_steiner must predict the size of the chain built by construct_chain_steiner, for every root
+TEST(steiner, scratch_matches_chain) {
+    const int side = 12, n_q = side * side, n_v = 5;
+    vector<vector<int>> qubit_nbrs(n_q), var_nbrs(n_v);
+    for (int x = 0; x < side; x++) {
+        for (int y = 0; y < side; y++) {
+            int q = x * side + y;
+            if (x + 1 < side) qubit_nbrs[q].push_back(q + side), qubit_nbrs[q + side].push_back(q);
+            if (y + 1 < side) qubit_nbrs[q].push_back(q + 1), qubit_nbrs[q + 1].push_back(q);
+        }
+    }
+    for (int v = 1; v < n_v; v++) var_nbrs[0].push_back(v), var_nbrs[v].push_back(0);
+
+    optional_parameters params;
+    std::mt19937 rng(5);
+    for (int trial = 0; trial < 10; trial++) {
+        int n_v_ = n_v, n_f = 0, n_q_ = n_q, n_r = 0;
+        problem_t ep(params, n_v_, n_f, n_q_, n_r, var_nbrs, qubit_nbrs);
+        embedding<problem_t> emb(ep);
+        vector<vector<int>> parents(n_v, vector<int>(n_q, -1));
+        vector<vector<distance_t>> distances(n_v, vector<distance_t>(n_q, max_distance));
+        vector<vector<int>> visited(n_v, vector<int>(n_q, 0));
+
+        vector<int> used(n_q, 0);
+        for (int v = 1; v < n_v; v++) {
+            int q;
+            do q = rng() % n_q;
+            while (used[q]);
+            used[q] = 1;
+            emb.set_chain(v, {q});
+            // a breadth-first search with shuffled adjacency, so that parents vary between trials
+            vector<int> level{q};
+            distances[v][q] = 0;
+            visited[v][q] = 1;
+            for (distance_t d = 1; level.size(); d++) {
+                vector<int> next;
+                for (auto &a : level) {
+                    vector<int> nbrs = qubit_nbrs[a];
+                    std::shuffle(nbrs.begin(), nbrs.end(), rng);
+                    for (auto &b : nbrs) {
+                        if (visited[v][b]) continue;
+                        visited[v][b] = 1;
+                        parents[v][b] = a;
+                        distances[v][b] = d;
+                        next.push_back(b);
+                    }
+                }
+                level.swap(next);
+            }
+        }
+
+        steiner_scratch scratch;
+        for (int q = 0; q < n_q; q++) {
+            if (used[q]) continue;
+            int predicted = emb.chainsize_steiner(0, q, parents, distances, visited, scratch);
+            emb.construct_chain_steiner(0, q, parents, distances, visited);
+            ASSERT_EQ(predicted, emb.chainsize(0));
+            // the chains built in bulk are linked both ways, across edges of the grid (or through a shared qubit,
+            // where a path from another neighbor runs through the chain of `v`)
+            ASSERT_TRUE(emb.linked(0));
+            for (int v = 1; v < n_v; v++) {
+                int a = emb.get_chain(0).get_link(v), b = emb.get_chain(v).get_link(0);
+                ASSERT_TRUE(a == b || std::count(qubit_nbrs[a].begin(), qubit_nbrs[a].end(), b) == 1);
+            }
+            emb.tear_out(0);
+        }
+    }
+}
+
+// a qubit masked out for a neighbor (visited == -1) is never a Steiner node for it, whatever its stale distance and
+// parent say.  variable 0 is rooted at qubit 3 and joined to variable 1 (at qubit 0) through 2 and 1, then to
+// variable 2 (at qubit 8) through 2 and 7, which leaves qubit 2 with two references.  qubit 2 is masked for variable 3
+// (at qubit 5), with a stale distance of zero and a parent that isn't next to it
+TEST(steiner, masked_qubits_are_not_steiner_nodes) {
+    int n_v = 4, n_f = 0, n_q = 9, n_r = 0;
+    vector<vector<int>> qubit_nbrs(n_q), var_nbrs(n_v);
+    for (auto &e : vector<std::pair<int, int>>{{0, 1}, {1, 2}, {2, 3}, {2, 7}, {7, 8}, {3, 4}, {4, 5}, {5, 6}}) {
+        qubit_nbrs[e.first].push_back(e.second);
+        qubit_nbrs[e.second].push_back(e.first);
+    }
+    for (int v = 1; v < n_v; v++) var_nbrs[0].push_back(v), var_nbrs[v].push_back(0);
+
+    optional_parameters params;
+    problem_t ep(params, n_v, n_f, n_q, n_r, var_nbrs, qubit_nbrs);
+    embedding<problem_t> emb(ep);
+    emb.set_chain(1, {0});
+    emb.set_chain(2, {8});
+    emb.set_chain(3, {5});
+
+    vector<vector<int>> parents(n_v, vector<int>(n_q, -1));
+    vector<vector<distance_t>> distances(n_v, vector<distance_t>(n_q, max_distance));
+    vector<vector<int>> visited(n_v, vector<int>(n_q, 0));
+    auto path = [&](int v, vector<int> qubits) {
+        for (size_t i = 0; i < qubits.size(); i++) {
+            visited[v][qubits[i]] = 1;
+            distances[v][qubits[i]] = i;
+            if (i) parents[v][qubits[i]] = qubits[i - 1];
+        }
+    };
+    path(1, {0, 1, 2, 3});
+    path(2, {8, 7, 2, 3});
+    path(3, {5, 4, 3});
+    visited[3][2] = -1;
+    distances[3][2] = 0;
+    parents[3][2] = 5;
+
+    emb.construct_chain_steiner(0, 3, parents, distances, visited);
+    ASSERT_TRUE(emb.linked(0));
+    EXPECT_EQ(emb.get_chain(0).get_link(3), 4);
+    for (int v = 1; v < n_v; v++) {
+        int a = emb.get_chain(0).get_link(v), b = emb.get_chain(v).get_link(0);
+        EXPECT_EQ(std::count(qubit_nbrs[a].begin(), qubit_nbrs[a].end(), b), 1);
+    }
+}
+
+// a chain held in scratch space loses and gains the same qubits to `steal_segment` as the chain itself does
+TEST(steiner, scratch_steals_like_chain) {
+    struct {
+        inline bool accepts_qubit(int, int) { return true; }
+    } mock;
+    const int n = 50;
+    vector<fill_t> weight(n, 0), scratch_weight(n, 0);
+    vector<int> parents(n, -1);
+    for (int i = 0; i < n; i++) parents[i] = i - 1;
+    chain c(weight, 0), d(weight, 1), e(weight, 2);
+    c.set_root(0);
+    d.set_root(49);
+    d.link_path(c, 49, parents);
+    e.set_root(48);
+    for (int i = 48; i;) i = parents[i] = i / 2;
+    e.link_path(c, 48, parents);
+
+    for (int target : {0, 20}) {
+        // c takes everything it can from its neighbors, and then gives some back
+        chain c0(weight, 0), d0(weight, 1), e0(weight, 2);
+        c0 = c, d0 = d, e0 = e;
+        chain c1(scratch_weight, 0), d1(scratch_weight, 1), e1(scratch_weight, 2);
+        c1 = c, d1 = d, e1 = e;
+        steiner_scratch scratch;
+
+        c0.steal(e0, mock);
+        c0.steal(d0, mock);
+        scratch.load(c1, vector<int>{1, 2}, n);
+        steal_segment(scratch, 0, e1, 2, mock, 0);
+        steal_segment(scratch, 0, d1, 1, mock, 0);
+        ASSERT_EQ(scratch.size(), c0.size());
+
+        e0.steal(c0, mock, target);
+        d0.steal(c0, mock, target);
+        steal_segment(e1, 2, scratch, 0, mock, target);
+        steal_segment(d1, 1, scratch, 0, mock, target);
+        c1.clear();
+        c1.assign_tree(scratch, 0);
+
+        for (auto pair : {std::make_pair(&c0, &c1), std::make_pair(&d0, &d1), std::make_pair(&e0, &e1)}) {
+            ASSERT_EQ(pair.first->size(), pair.second->size());
+            ASSERT_EQ(pair.second->run_diagnostic(), 0);
+            for (auto &q : *pair.first) ASSERT_EQ(pair.second->count(q), 1);
+            for (int v = 0; v < 3; v++) ASSERT_EQ(pair.first->get_link(v), pair.second->get_link(v));
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include "embedding_problem.hpp"
+#include "gtest/gtest.h"
+using namespace find_embedding;
+using std::vector;
+
+typedef embedding_problem<fixed_handler_none, domain_handler_universe, output_handler_error> problem_t;
+
+// the priority first search as it was first written: every candidate is queued with a fresh count of its visited
+// neighbors each time one of them is visited, and stale entries are skipped when they come up
+template <typename queue_t>
+static void reference_component(int x, const vector<vector<int>> &neighbors, vector<int> &component,
+                                vector<int> &visited, const vector<int> &shuffled) {
+    queue_t pq;
+    pq.emplace(x, shuffled[x], 0);
+    while (!pq.empty()) {
+        auto z = pq.top();
+        pq.pop();
+        x = z.node;
+        if (visited[x]) continue;
+        visited[x] = 1;
+        component.push_back(x);
+        for (auto y : neighbors[x]) {
+            if (!visited[y]) {
+                int d = 0;
+                for (auto w : neighbors[y]) d -= visited[w];
+                pq.emplace(y, shuffled[y], d);
+            }
+        }
+    }
+}
+
+// the incremental searches give the same orders as the reference, on sparse and dense sources with fixed variables
+TEST(var_order, pfs_matches_reference) {
+    const int n_q = 64;
+    vector<vector<int>> qubit_nbrs(n_q);
+    for (int q = 0; q < n_q; q++) {
+        qubit_nbrs[q].push_back((q + 1) % n_q);
+        qubit_nbrs[(q + 1) % n_q].push_back(q);
+    }
+    std::mt19937 rng(11);
+    for (int trial = 0; trial < 20; trial++) {
+        int n_v = 10 + rng() % 60, n_f = rng() % 4, n_r = 0, n_q_ = n_q;
+        int edges = (n_v + n_f) * (1 + rng() % 12);
+        vector<std::set<int>> nbr_sets(n_v + n_f);
+        for (int i = 0; i < edges; i++) {
+            int a = rng() % (n_v + n_f), b = rng() % (n_v + n_f);
+            if (a == b || (a >= n_v && b >= n_v)) continue;
+            nbr_sets[a].insert(b);
+            nbr_sets[b].insert(a);
+        }
+        vector<vector<int>> var_nbrs;
+        for (auto &s : nbr_sets) var_nbrs.emplace_back(s.begin(), s.end());
+
+        optional_parameters params;
+        params.seed(trial);
+        problem_t ep(params, n_v, n_f, n_q_, n_r, var_nbrs, qubit_nbrs);
+        for (auto order : {VARORDER_PFS, VARORDER_RPFS}) {
+            // replay the shuffle that var_order draws
+            fastrng replay = params.rng;
+            vector<int> shuffled;
+            for (int v = n_v; v--;) shuffled.push_back(v);
+            std::shuffle(shuffled.begin(), shuffled.end(), replay);
+            vector<int> visited(n_v, 0), expected;
+            visited.resize(n_v + n_f, 1);
+            for (auto v : shuffled) {
+                if (visited[v]) continue;
+                if (order == VARORDER_PFS)
+                    reference_component<min_queue<int>>(v, var_nbrs, expected, visited, shuffled);
+                else
+                    reference_component<max_queue<int>>(v, var_nbrs, expected, visited, shuffled);
+            }
+            ASSERT_EQ(ep.var_order(order), expected) << "trial " << trial << " order " << order;
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#include <vector>
+#include "generators.hpp"
+#include "gtest/gtest.h"
+#include "verify.hpp"
+using namespace find_embedding;
+using std::vector;
+
+static void expect_fault(const verify_result &r, VERIFY status, int u, int v, int q) {
+    EXPECT_EQ(r.status, status);
+    EXPECT_EQ(r.u, u);
+    EXPECT_EQ(r.v, v);
+    EXPECT_EQ(r.q, q);
+}
+
+// a triangle in a single chimera cell, where qubits 0-3 are coupled to 4-7 and not to each other
+TEST(verify, faults) {
+    graph::input_graph triangle = graph::clique(3), cell = graph::chimera(1);
+    EXPECT_TRUE(verify_embedding(triangle, cell, {{0, 4}, {1}, {5}}));
+    expect_fault(verify_embedding(triangle, cell, {{0, 4}, {1}}), VERIFY_MISSING_CHAIN, 2, -1, -1);
+    expect_fault(verify_embedding(triangle, cell, {{0, 4}, {}, {5}}), VERIFY_MISSING_CHAIN, 1, -1, -1);
+    expect_fault(verify_embedding(triangle, cell, {{0, 4}, {8}, {5}}), VERIFY_BAD_QUBIT, 1, -1, 8);
+    expect_fault(verify_embedding(triangle, cell, {{0, 4}, {4}, {5}}), VERIFY_OVERLAP, 0, 1, 4);
+    expect_fault(verify_embedding(triangle, cell, {{0, 1}, {4}, {5}}), VERIFY_BROKEN_CHAIN, 0, -1, -1);
+    expect_fault(verify_embedding(triangle, cell, {{0}, {1}, {4}}), VERIFY_MISSING_EDGE, 0, 1, -1);
+    // an extra chain is an isolated variable
+    EXPECT_TRUE(verify_embedding(triangle, cell, {{0, 4}, {1}, {5}, {2, 6}}));
+    expect_fault(verify_embedding(triangle, cell, {{0, 4}, {1}, {5}, {2, 3}}), VERIFY_BROKEN_CHAIN, 3, -1, -1);
+}
+
+// a 6x6 grid in a 12x12 grid, with L-shaped chains; damage to it is reported the same way for any number of threads
+TEST(verify, threads) {
+    int n = 6, m = 2 * n;
+    graph::input_graph source = graph::grid(n, n), target = graph::grid(m, m);
+    vector<vector<int>> chains;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            int corner = 2 * i * m + 2 * j;
+            chains.push_back({corner, corner + 1, corner + m});
+        }
+    for (int t = 1; t <= 8; t++) EXPECT_TRUE(verify_embedding(source, target, chains, t));
+
+    // cut the first and last variables off from the rest of their chains, by moving those to the unused qubit
+    // diagonally across
+    vector<vector<int>> broken = chains;
+    for (int u : {n * n - 1, 0}) broken[u] = {chains[u][0], chains[u][0] + m + 1};
+    for (int t = 1; t <= 8; t++)
+        expect_fault(verify_embedding(source, target, broken, t), VERIFY_BROKEN_CHAIN, 0, -1, -1);
+
+    vector<vector<int>> stolen = chains;
+    stolen[n * n - 1].push_back(chains[2][0]);
+    expect_fault(verify_embedding(source, target, stolen, 4), VERIFY_OVERLAP, 2, n * n - 1, chains[2][0]);
+}
@@ -0,0 +1,102 @@
+#include <vector>
+#include "generators.hpp"
+#include "gtest/gtest.h"
+#include "pathfinder.hpp"
+using namespace find_embedding;
+using std::vector;
+
+namespace {
+class quiet_interaction : public LocalInteraction {
+    virtual void displayOutputImpl(const std::string &) const {}
+    virtual bool cancelledImpl() const { return false; }
+};
+}
+
+// a margin of 2^62 leaves the integer distances too little room for any penalty, but not the floating point ones
+TEST(weight_handlers, exponent_budget) {
+    const uint64_t margin = UINT64_C(1) << 62;
+    EXPECT_LT(embedding_problem_base::exponent_budget(weight_handler_narrow::exponent_bits, margin), 2);
+    EXPECT_EQ(embedding_problem_base::exponent_budget(weight_handler_wide::exponent_bits, margin), 63);
+    // the narrow budget is unchanged for ordinary problems
+    EXPECT_EQ(embedding_problem_base::exponent_budget(weight_handler_narrow::exponent_bits, 1024), 53);
+
+    vector<vector<int>> var_nbrs(3, vector<int>(1 << 16));
+    EXPECT_EQ(embedding_problem_base::compute_margin(var_nbrs, 1 << 20), UINT64_C(1) << 36);
+}
+
+// lexicographic weights put any number of free qubits before one used qubit, and one qubit used twice after two
+// used once
+TEST(weight_handlers, lexicographic_order) {
+    for (uint64_t margin : {UINT64_C(1), UINT64_C(1000), UINT64_C(1) << 40}) {
+        weight_handler_lexicographic wh(margin);
+        const distance_t longest = (distance_t(1) << wh.length_bits) - 1;
+        EXPECT_GE(longest, margin);
+        EXPECT_EQ(wh.weight(0, 1), 1);
+        EXPECT_GT(wh.weight(1, 1), longest * wh.weight(0, 1));
+        EXPECT_GT(wh.weight(2, 1), 2 * wh.weight(1, 1));
+        EXPECT_LT(wh.weight(wh.exponent_bits - 1, 1), max_distance);
+        EXPECT_EQ(wh.weight(wh.exponent_bits, 1), max_distance);
+    }
+}
+
+// the length field takes just the bits to hold the margin, so that the overlap gets the rest: embedding K30 into C16
+// leaves the overlap 31 bits, and the lexicographic weights only run out of room past a margin of 2^30
+TEST(weight_handlers, lexicographic_length_bits) {
+    EXPECT_EQ(weight_handler_lexicographic::length_bits_for(1), 1);
+    EXPECT_EQ(weight_handler_lexicographic::length_bits_for(1023), 10);
+    EXPECT_EQ(weight_handler_lexicographic::length_bits_for(1024), 11);
+
+    auto budget = [](uint64_t margin) {
+        return embedding_problem_base::exponent_budget(weight_handler_lexicographic(margin).exponent_bits, margin);
+    };
+    const uint64_t clique_margin = 29 * 2048;
+    EXPECT_EQ(weight_handler_lexicographic(clique_margin).length_bits, 16);
+    EXPECT_EQ(static_cast<int>(budget(clique_margin)), 31);
+    EXPECT_GE(budget(UINT64_C(1) << 30), 2);
+    EXPECT_LT(budget(UINT64_C(1) << 31), 2);
+}
+
+// the pathfinders run unchanged on any weight handler; findEmbedding builds the wide and lexicographic ones only
+// with the handlers which decide fixed chains, restrictions, threads and verbosity at runtime, so those are used here
+template <typename weight_handler>
+void check_embedding() {
+    typedef embedding_problem<fixed_handler_hival, domain_handler_ranged, output_handler_full, weight_handler>
+            problem_t;
+    graph::input_graph source = graph::clique(8), target = graph::chimera(4);
+    int n_v = source.num_nodes(), n_q = target.num_nodes();
+    vector<vector<int>> var_nbrs(n_v), qubit_nbrs(n_q);
+    for (int i = 0; i < source.num_edges(); i++) {
+        var_nbrs[source.a(i)].push_back(source.b(i));
+        var_nbrs[source.b(i)].push_back(source.a(i));
+    }
+    for (int i = 0; i < target.num_edges(); i++) {
+        qubit_nbrs[target.a(i)].push_back(target.b(i));
+        qubit_nbrs[target.b(i)].push_back(target.a(i));
+    }
+
+    optional_parameters params;
+    params.localInteractionPtr.reset(new quiet_interaction());
+    params.tries = 4;
+    params.seed(1);
+    pathfinder_hybrid<problem_t> pf(params, n_v, 0, n_q, 0, var_nbrs, qubit_nbrs);
+    ASSERT_EQ(pf.heuristicEmbedding(), 1);
+
+    vector<int> owner(n_q, -1);
+    for (int v = 0; v < n_v; v++) {
+        ASSERT_GT(pf.get_chain(v).size(), 0);
+        for (auto &q : pf.get_chain(v)) {
+            ASSERT_EQ(owner[q], -1);
+            owner[q] = v;
+        }
+    }
+    vector<vector<int>> coupled(n_v, vector<int>(n_v, 0));
+    for (int i = 0; i < target.num_edges(); i++) {
+        int u = owner[target.a(i)], v = owner[target.b(i)];
+        if (u >= 0 && v >= 0) coupled[u][v] = coupled[v][u] = 1;
+    }
+    for (int i = 0; i < source.num_edges(); i++) EXPECT_TRUE(coupled[source.a(i)][source.b(i)]);
+}
+
+TEST(weight_handlers, wide_embedding) { check_embedding<weight_handler_wide>(); }
+
+TEST(weight_handlers, lexicographic_embedding) { check_embedding<weight_handler_lexicographic>(); }